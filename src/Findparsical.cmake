@@ -24,6 +24,27 @@ find_library(PARSICAL_LIBRARY
 set(PARSICAL_INCLUDE_DIRS ${PARSICAL_INCLUDE_DIR})
 set(PARSICAL_LIBRARIES ${PARSICAL_LIBRARY})
 
+# parsical always needs threads.
+find_package(Threads REQUIRED)
+list(APPEND PARSICAL_LIBRARIES Threads::Threads)
+
+# The decompression libraries parsical was built against, as recorded next to
+# the library when it was installed.
+if(PARSICAL_LIBRARY)
+  get_filename_component(PARSICAL_LIBRARY_DIR ${PARSICAL_LIBRARY} DIRECTORY)
+  include("${PARSICAL_LIBRARY_DIR}/parsical-deps.cmake" OPTIONAL)
+endif()
+
+if(PARSICAL_WITH_ZLIB)
+  find_package(ZLIB REQUIRED)
+  list(APPEND PARSICAL_LIBRARIES ${ZLIB_LIBRARIES})
+endif()
+
+if(PARSICAL_WITH_ZSTD)
+  find_library(ZSTD_LIBRARY zstd)
+  list(APPEND PARSICAL_LIBRARIES ${ZSTD_LIBRARY})
+endif()
+
 include(FindPackageHandleStandardArgs)
 find_package_handle_standard_args(
   PARSICAL
@@ -9,8 +9,31 @@
 #define _PARSICAL_HPP_
 
 #include "parsical/parsestream.hpp"
+#include "parsical/arena.hpp"
+#include "parsical/batch.hpp"
+#include "parsical/batchreader.hpp"
+#include "parsical/context.hpp"
+#include "parsical/decompressparser.hpp"
+#include "parsical/executor.hpp"
+#include "parsical/failures.hpp"
+#include "parsical/iteratorparser.hpp"
+#include "parsical/lineindex.hpp"
+#include "parsical/mappedfile.hpp"
+#include "parsical/parallel.hpp"
+#include "parsical/pins.hpp"
+#include "parsical/pushparser.hpp"
+#include "parsical/readaheadparser.hpp"
+#include "parsical/recordindex.hpp"
+#include "parsical/reverseparser.hpp"
+#include "parsical/ringparser.hpp"
+#include "parsical/segmentedparser.hpp"
+#include "parsical/smallvector.hpp"
+#include "parsical/span.hpp"
+#include "parsical/symbols.hpp"
+#include "parsical/threadpool.hpp"
 #include "parsical/parseerror.hpp"
 #include "parsical/general.hpp"
+#include "parsical/grammar.hpp"
 #include "parsical/string.hpp"
 
 #endif
@@ -0,0 +1,109 @@
+#include "arena.hpp"
+
+//////////////
+// Includes //
+#include <cstdint>
+#include <cstring>
+
+//////////
+// Code //
+
+// Moving on to the next chunk that can fit size bytes, allocating
+// one if there isn't one.
+void parsical::ParseArena::grow(std::size_t size) {
+    while (++current < chunks.size()) {
+        if (chunks[current].second >= size) {
+            cur = chunks[current].first;
+            end = cur + chunks[current].second;
+            return;
+        }
+    }
+
+    std::size_t bytes = size > chunkSize ? size : chunkSize;
+    if (bytes > chunkSize)
+        oversized++;
+    chunks.push_back(std::make_pair(static_cast<char*>(::operator new(bytes)), bytes));
+
+    current = chunks.size() - 1;
+    cur = chunks[current].first;
+    end = cur + bytes;
+}
+
+// Creating a ParseArena that allocates in chunks of the given size.
+parsical::ParseArena::ParseArena(std::size_t chunkSize) :
+        current(0),
+        cur(nullptr),
+        end(nullptr),
+        chunkSize(chunkSize > 0 ? chunkSize : 1),
+        oversized(0),
+        used(0),
+        finalizers(nullptr) { }
+
+// Freeing every chunk.
+parsical::ParseArena::~ParseArena() {
+    reset();
+    for (std::pair<char*, std::size_t>& chunk: chunks)
+        ::operator delete(chunk.first);
+}
+
+// Allocating size bytes with the given alignment.
+void* parsical::ParseArena::allocate(std::size_t size, std::size_t align) {
+    std::uintptr_t at = (reinterpret_cast<std::uintptr_t>(cur) + align - 1) & ~(align - 1);
+    if (cur == nullptr || at + size > reinterpret_cast<std::uintptr_t>(end)) {
+        // Chunks come from operator new, so they're already aligned for
+        // anything that isn't over-aligned.
+        grow(size + align);
+        at = (reinterpret_cast<std::uintptr_t>(cur) + align - 1) & ~(align - 1);
+    }
+
+    cur = reinterpret_cast<char*>(at + size);
+    used += size;
+
+    return reinterpret_cast<void*>(at);
+}
+
+// Copying a run of characters into the arena.
+const char* parsical::ParseArena::copy(const char* data, std::size_t size) {
+    char* to = static_cast<char*>(allocate(size, 1));
+    std::memcpy(to, data, size);
+    return to;
+}
+
+// Making all of the memory in the arena available again. This runs
+// the destructors registered by make, and frees any chunk that was
+// bigger than the chunk size; otherwise it's constant time.
+void parsical::ParseArena::reset() noexcept {
+    for (Finalizer* f = finalizers; f != nullptr; f = f->next)
+        f->destroy(f->object);
+    finalizers = nullptr;
+
+    // Oversized chunks were made for one big allocation - they're not worth
+    // holding on to.
+    if (oversized > 0) {
+        std::size_t kept = 0;
+        for (std::size_t i = 0; i < chunks.size(); i++) {
+            if (chunks[i].second > chunkSize)
+                ::operator delete(chunks[i].first);
+            else
+                chunks[kept++] = chunks[i];
+        }
+        chunks.resize(kept);
+        oversized = 0;
+    }
+
+    current = 0;
+    cur = chunks.empty() ? nullptr : chunks[0].first;
+    end = chunks.empty() ? nullptr : cur + chunks[0].second;
+    used = 0;
+}
+
+// The number of bytes handed out since the last reset.
+std::size_t parsical::ParseArena::bytesUsed() const noexcept { return used; }
+
+// The number of bytes held in chunks.
+std::size_t parsical::ParseArena::bytesReserved() const noexcept {
+    std::size_t total = 0;
+    for (const std::pair<char*, std::size_t>& chunk: chunks)
+        total += chunk.second;
+    return total;
+}
@@ -0,0 +1,120 @@
+// Name: parsical/arena.hpp
+//
+// Description:
+//   A bump allocator for parse results, which can be thrown away all at once
+//   when a document is done and reused for the next one.
+
+#ifndef _PARSICAL_ARENA_HPP_
+#define _PARSICAL_ARENA_HPP_
+
+//////////////
+// Includes //
+#include <cstddef>
+#include <new>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+//////////
+// Code //
+
+namespace parsical {
+    // Memory is handed out by bumping a pointer through fixed-size chunks.
+    // Nothing is freed piece by piece: reset() makes all of it available
+    // again in one go, and keeps the chunks around so a later document doesn't
+    // have to go back to the global heap. A ParseArena is not thread-safe -
+    // the idea is to have one per thread.
+    class ParseArena {
+    private:
+        // A destructor to run on reset, for objects made with make that need
+        // one. These live in the arena themselves.
+        struct Finalizer {
+            void (*destroy)(void*);
+            void* object;
+            Finalizer* next;
+        };
+
+        std::vector<std::pair<char*, std::size_t>> chunks;
+        std::size_t current;
+        char* cur;
+        char* end;
+        std::size_t chunkSize;
+        std::size_t oversized;
+        std::size_t used;
+        Finalizer* finalizers;
+
+        // Moving on to the next chunk that can fit size bytes, allocating
+        // one if there isn't one.
+        void grow(std::size_t);
+
+        // Destroying an object of type T.
+        template <typename T>
+        static void destroy(void*);
+
+    public:
+        // Creating a ParseArena that allocates in chunks of the given size.
+        ParseArena(std::size_t chunkSize = 1 << 16);
+
+        // Freeing every chunk.
+        ~ParseArena();
+
+        ParseArena(const ParseArena&) = delete;
+        ParseArena& operator=(const ParseArena&) = delete;
+
+        // Allocating size bytes with the given alignment.
+        void* allocate(std::size_t, std::size_t align = alignof(std::max_align_t));
+
+        // Constructing a T in the arena. If T has a non-trivial destructor,
+        // it's run on reset.
+        template <typename T,
+                  typename... Args>
+        T* make(Args&&...);
+
+        // Copying a run of characters into the arena.
+        const char* copy(const char*, std::size_t);
+
+        // Making all of the memory in the arena available again. This runs
+        // the destructors registered by make, and frees any chunk that was
+        // bigger than the chunk size; otherwise it's constant time.
+        void reset() noexcept;
+
+        // The number of bytes handed out since the last reset.
+        std::size_t bytesUsed() const noexcept;
+
+        // The number of bytes held in chunks.
+        std::size_t bytesReserved() const noexcept;
+    };
+
+    // A standard library allocator that allocates out of a ParseArena.
+    // Deallocation does nothing; the memory comes back on reset.
+    template <typename T>
+    struct ArenaAllocator {
+        typedef T value_type;
+
+        ParseArena* arena;
+
+        // Creating an ArenaAllocator over an arena.
+        ArenaAllocator(ParseArena&) noexcept;
+
+        // Converting from an ArenaAllocator of another type.
+        template <typename U>
+        ArenaAllocator(const ArenaAllocator<U>&) noexcept;
+
+        // Allocating room for n values.
+        T* allocate(std::size_t);
+
+        // Deallocating does nothing.
+        void deallocate(T*, std::size_t) noexcept;
+    };
+
+    // ArenaAllocators are interchangeable when they share an arena.
+    template <typename T, typename U>
+    bool operator==(const ArenaAllocator<T>&, const ArenaAllocator<U>&) noexcept;
+
+    template <typename T, typename U>
+    bool operator!=(const ArenaAllocator<T>&, const ArenaAllocator<U>&) noexcept;
+}
+
+#include "arena.tpp"
+
+#endif
@@ -0,0 +1,63 @@
+#include "arena.hpp"
+
+////
+// ParseArena
+
+// Destroying an object of type T.
+template <typename T>
+void parsical::ParseArena::destroy(void* object) {
+    static_cast<T*>(object)->~T();
+}
+
+// Constructing a T in the arena. If T has a non-trivial destructor,
+// it's run on reset.
+template <typename T,
+          typename... Args>
+T* parsical::ParseArena::make(Args&&... args) {
+    T* object = new (allocate(sizeof(T), alignof(T))) T(std::forward<Args>(args)...);
+
+    if (!std::is_trivially_destructible<T>::value) {
+        Finalizer* finalizer = new (allocate(sizeof(Finalizer), alignof(Finalizer))) Finalizer;
+        finalizer->destroy = &parsical::ParseArena::destroy<T>;
+        finalizer->object = object;
+        finalizer->next = finalizers;
+        finalizers = finalizer;
+    }
+
+    return object;
+}
+
+////
+// ArenaAllocator
+
+// Creating an ArenaAllocator over an arena.
+template <typename T>
+parsical::ArenaAllocator<T>::ArenaAllocator(parsical::ParseArena& arena) noexcept :
+        arena(&arena) { }
+
+// Converting from an ArenaAllocator of another type.
+template <typename T>
+template <typename U>
+parsical::ArenaAllocator<T>::ArenaAllocator(const parsical::ArenaAllocator<U>& other) noexcept :
+        arena(other.arena) { }
+
+// Allocating room for n values.
+template <typename T>
+T* parsical::ArenaAllocator<T>::allocate(std::size_t n) {
+    return static_cast<T*>(arena->allocate(n * sizeof(T), alignof(T)));
+}
+
+// Deallocating does nothing.
+template <typename T>
+void parsical::ArenaAllocator<T>::deallocate(T*, std::size_t) noexcept { }
+
+// ArenaAllocators are interchangeable when they share an arena.
+template <typename T, typename U>
+bool parsical::operator==(const parsical::ArenaAllocator<T>& a, const parsical::ArenaAllocator<U>& b) noexcept {
+    return a.arena == b.arena;
+}
+
+template <typename T, typename U>
+bool parsical::operator!=(const parsical::ArenaAllocator<T>& a, const parsical::ArenaAllocator<U>& b) noexcept {
+    return a.arena != b.arena;
+}
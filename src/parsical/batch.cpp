@@ -0,0 +1,22 @@
+#include "batch.hpp"
+
+//////////////
+// Includes //
+#include "threadpool.hpp"
+
+//////////
+// Code //
+
+// Creating an idle BatchWorker.
+parsical::BatchWorker::BatchWorker() :
+        stream(nullptr, nullptr),
+        context(&arena) {
+    stream.setContext(&context);
+}
+
+// The ThreadPool used by parseBatch when no Executor is given. It's
+// created on first use, with a worker per hardware thread.
+parsical::Executor& parsical::defaultExecutor() {
+    static parsical::ThreadPool pool;
+    return pool;
+}
@@ -0,0 +1,73 @@
+// Name: parsical/batch.hpp
+//
+// Description:
+//   Parsing large batches of small, independent documents across threads.
+
+#ifndef _PARSICAL_BATCH_HPP_
+#define _PARSICAL_BATCH_HPP_
+
+//////////////
+// Includes //
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "parsestream.hpp"
+#include "parseerror.hpp"
+#include "arena.hpp"
+#include "context.hpp"
+#include "executor.hpp"
+#include "iteratorparser.hpp"
+
+//////////
+// Code //
+
+namespace parsical {
+    // The outcome of parsing a single document in a batch. If ok is false,
+    // value is default-constructed and error is the ParseError that was
+    // thrown; otherwise error is null.
+    template <typename ReturnType>
+    struct BatchResult {
+        bool ok;
+        ReturnType value;
+        std::shared_ptr<ParseError> error;
+    };
+
+    // The state a single worker reuses from document to document.
+    struct BatchWorker {
+        IteratorParser<const char*> stream;
+        ParseArena arena;
+        ParseContext context;
+
+        // Creating an idle BatchWorker.
+        BatchWorker();
+
+        BatchWorker(const BatchWorker&) = delete;
+        BatchWorker& operator=(const BatchWorker&) = delete;
+    };
+
+    // Parsing every document with the grammar on the given Executor, and
+    // getting back one result per document, in order. Each worker parses
+    // all of its documents with the same stream, which has a ParseArena
+    // attached. The arena is reset before every document, so it's for
+    // scratch work - a result must not point into it. A document failing to
+    // parse doesn't affect any of the others. The grammar is called from
+    // many threads at once.
+    template <typename ReturnType,
+              typename FunctionType>
+    std::vector<BatchResult<ReturnType>> parseBatch(const std::vector<std::string>&, FunctionType, Executor&);
+
+    // The same as above, run on a ThreadPool shared by every call that
+    // doesn't bring its own Executor.
+    template <typename ReturnType,
+              typename FunctionType>
+    std::vector<BatchResult<ReturnType>> parseBatch(const std::vector<std::string>&, FunctionType);
+
+    // The ThreadPool used by parseBatch when no Executor is given. It's
+    // created on first use, with a worker per hardware thread.
+    Executor& defaultExecutor();
+}
+
+#include "batch.tpp"
+
+#endif
@@ -0,0 +1,42 @@
+#include "batch.hpp"
+
+// Parsing every document with the grammar on the given Executor, and
+// getting back one result per document, in order. Each worker parses
+// all of its documents with the same stream, which has a ParseArena
+// attached. The arena is reset before every document, so it's for
+// scratch work - a result must not point into it. A document failing to
+// parse doesn't affect any of the others. The grammar is called from
+// many threads at once.
+template <typename ReturnType,
+          typename FunctionType>
+std::vector<parsical::BatchResult<ReturnType>> parsical::parseBatch(const std::vector<std::string>& documents, FunctionType fn, parsical::Executor& executor) {
+    std::vector<parsical::BatchResult<ReturnType>> results(documents.size());
+    std::vector<parsical::BatchWorker> workers(executor.size());
+
+    executor.run(documents.size(), [&](std::size_t w, std::size_t i) {
+        parsical::BatchWorker& worker = workers[w];
+        parsical::BatchResult<ReturnType>& result = results[i];
+        const std::string& document = documents[i];
+
+        worker.arena.reset();
+        worker.stream.reset(document.data(), document.data() + document.size());
+        try {
+            result.value = fn(worker.stream);
+            result.ok = true;
+        } catch (parsical::ParseError& e) {
+            result.ok = false;
+            result.error = std::make_shared<parsical::ParseError>(e);
+            result.error->locate(worker.stream.pos());
+        }
+    });
+
+    return results;
+}
+
+// The same as above, run on a ThreadPool shared by every call that
+// doesn't bring its own Executor.
+template <typename ReturnType,
+          typename FunctionType>
+std::vector<parsical::BatchResult<ReturnType>> parsical::parseBatch(const std::vector<std::string>& documents, FunctionType fn) {
+    return parsical::parseBatch<ReturnType>(documents, fn, parsical::defaultExecutor());
+}
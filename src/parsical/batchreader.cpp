@@ -0,0 +1,377 @@
+#include "batchreader.hpp"
+
+//////////////
+// Includes //
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <deque>
+
+#include "parsestream.hpp"
+#include "segmentedparser.hpp"
+
+#if defined(__linux__) && defined(__has_include)
+#if __has_include(<linux/io_uring.h>)
+#define PARSICAL_HAVE_IO_URING
+#endif
+#endif
+
+#ifdef PARSICAL_HAVE_IO_URING
+#include <fcntl.h>
+#include <linux/io_uring.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+#include <sys/uio.h>
+#include <unistd.h>
+#endif
+
+//////////
+// Code //
+
+#ifdef PARSICAL_HAVE_IO_URING
+
+// A bare-bones io_uring, talking to the kernel through raw syscalls so there's
+// no dependency on liburing.
+struct parsical::BatchFileReader::Ring {
+    int fd;
+
+    void* sqPtr;
+    std::size_t sqSize;
+    void* cqPtr;
+    std::size_t cqSize;
+    void* sqePtr;
+    std::size_t sqeSize;
+
+    unsigned* sqHead;
+    unsigned* sqTail;
+    unsigned* sqMask;
+    unsigned* sqArray;
+    unsigned* cqHead;
+    unsigned* cqTail;
+    unsigned* cqMask;
+    io_uring_sqe* sqes;
+    io_uring_cqe* cqes;
+
+    Ring() :
+            fd(-1),
+            sqPtr(nullptr),
+            cqPtr(nullptr),
+            sqePtr(nullptr) { }
+
+    ~Ring() { teardown(); }
+
+    // Setting up a ring with the given number of entries. Returns false if
+    // the kernel doesn't support (or won't allow) io_uring.
+    bool setup(unsigned entries) noexcept {
+        io_uring_params params;
+        std::memset(&params, 0, sizeof(params));
+
+        fd = syscall(__NR_io_uring_setup, entries, &params);
+        if (fd < 0)
+            return false;
+
+        sqSize = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+        cqSize = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+        sqeSize = params.sq_entries * sizeof(io_uring_sqe);
+
+        sqPtr = mmap(nullptr, sqSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_SQ_RING);
+        cqPtr = mmap(nullptr, cqSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_CQ_RING);
+        sqePtr = mmap(nullptr, sqeSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_SQES);
+        if (sqPtr == MAP_FAILED || cqPtr == MAP_FAILED || sqePtr == MAP_FAILED) {
+            teardown();
+            return false;
+        }
+
+        char* sq = static_cast<char*>(sqPtr);
+        sqHead = reinterpret_cast<unsigned*>(sq + params.sq_off.head);
+        sqTail = reinterpret_cast<unsigned*>(sq + params.sq_off.tail);
+        sqMask = reinterpret_cast<unsigned*>(sq + params.sq_off.ring_mask);
+        sqArray = reinterpret_cast<unsigned*>(sq + params.sq_off.array);
+        sqes = static_cast<io_uring_sqe*>(sqePtr);
+
+        char* cq = static_cast<char*>(cqPtr);
+        cqHead = reinterpret_cast<unsigned*>(cq + params.cq_off.head);
+        cqTail = reinterpret_cast<unsigned*>(cq + params.cq_off.tail);
+        cqMask = reinterpret_cast<unsigned*>(cq + params.cq_off.ring_mask);
+        cqes = reinterpret_cast<io_uring_cqe*>(cq + params.cq_off.cqes);
+
+        return true;
+    }
+
+    // Unmapping and closing the ring.
+    void teardown() noexcept {
+        if (sqPtr != nullptr && sqPtr != MAP_FAILED)
+            munmap(sqPtr, sqSize);
+        if (cqPtr != nullptr && cqPtr != MAP_FAILED)
+            munmap(cqPtr, cqSize);
+        if (sqePtr != nullptr && sqePtr != MAP_FAILED)
+            munmap(sqePtr, sqeSize);
+        if (fd >= 0)
+            close(fd);
+        fd = -1;
+    }
+
+    // Queueing up a readv. The iovec has to stay alive until it completes.
+    void pushRead(int file, iovec* vec, std::size_t offset, unsigned long long data) noexcept {
+        unsigned tail = *sqTail;
+        unsigned index = tail & *sqMask;
+
+        io_uring_sqe* sqe = &sqes[index];
+        std::memset(sqe, 0, sizeof(*sqe));
+        sqe->opcode = IORING_OP_READV;
+        sqe->fd = file;
+        sqe->addr = reinterpret_cast<unsigned long long>(vec);
+        sqe->len = 1;
+        sqe->off = offset;
+        sqe->user_data = data;
+
+        sqArray[index] = index;
+        __atomic_store_n(sqTail, tail + 1, __ATOMIC_RELEASE);
+    }
+
+    // Submitting what is queued, and waiting for at least one completion.
+    // Returns how many were submitted, which may be fewer than asked.
+    int submitAndWait(unsigned submit) noexcept {
+        int ret;
+        do {
+            ret = syscall(__NR_io_uring_enter, fd, submit, 1, IORING_ENTER_GETEVENTS, nullptr, 0);
+        } while (ret < 0 && errno == EINTR);
+        return ret;
+    }
+
+    // Taking a completion off of the queue, if there is one.
+    bool pop(unsigned long long& data, int& res) noexcept {
+        unsigned head = *cqHead;
+        if (head == __atomic_load_n(cqTail, __ATOMIC_ACQUIRE))
+            return false;
+
+        io_uring_cqe* cqe = &cqes[head & *cqMask];
+        data = cqe->user_data;
+        res = cqe->res;
+
+        __atomic_store_n(cqHead, head + 1, __ATOMIC_RELEASE);
+        return true;
+    }
+};
+
+namespace {
+    // A single file being read.
+    struct PendingFile {
+        int fd;
+        std::size_t size;
+        std::size_t next;
+        std::size_t outstanding;
+        std::vector<std::vector<char>> chunks;
+    };
+
+    // A single read in flight.
+    struct PendingRead {
+        std::size_t file;
+        std::size_t chunk;
+        std::size_t offset;
+        std::size_t done;
+        iovec vec;
+    };
+}
+
+// Reading the files with io_uring.
+void parsical::BatchFileReader::readRing(const std::vector<std::string>& paths, const std::function<void(std::size_t, parsical::ParseStream<char>&)>& fn) {
+    std::vector<PendingFile> files(paths.size());
+    for (PendingFile& file: files)
+        file.fd = -1;
+    std::vector<PendingRead> reads(queueDepth);
+    std::vector<std::size_t> freeReads;
+    for (std::size_t i = 0; i < queueDepth; i++)
+        freeReads.push_back(queueDepth - 1 - i);
+
+    // Files that are open and still have chunks left to queue up.
+    std::deque<std::size_t> reading;
+    std::size_t opened = 0;
+    std::size_t inFlight = 0;
+    unsigned queued = 0;
+
+    // Handing a finished file to the callback.
+    auto finish = [&](std::size_t i) {
+        PendingFile& file = files[i];
+        close(file.fd);
+        file.fd = -1;
+
+        std::vector<parsical::Segment> segments;
+        for (const std::vector<char>& chunk: file.chunks)
+            segments.push_back({ chunk.data(), chunk.size() });
+
+        parsical::SegmentedParser stream(segments);
+        fn(i, stream);
+
+        std::vector<std::vector<char>>().swap(file.chunks);
+    };
+
+    // Queueing up (the rest of) a read.
+    auto push = [&](std::size_t r) {
+        PendingRead& read = reads[r];
+        std::vector<char>& chunk = files[read.file].chunks[read.chunk];
+        read.vec.iov_base = chunk.data() + read.done;
+        read.vec.iov_len = chunk.size() - read.done;
+
+        ring->pushRead(files[read.file].fd, &read.vec, read.offset + read.done, r);
+        inFlight++;
+        queued++;
+    };
+
+    try {
+        while (opened < paths.size() || !reading.empty() || inFlight > 0) {
+            // Filling up the queue, opening more files as needed.
+            while (!freeReads.empty() && (opened < paths.size() || !reading.empty())) {
+                if (reading.empty()) {
+                    std::size_t i = opened++;
+                    PendingFile& file = files[i];
+
+                    struct stat st;
+                    file.fd = open(paths[i].c_str(), O_RDONLY | O_CLOEXEC);
+                    if (file.fd < 0 || fstat(file.fd, &st) < 0)
+                        throw std::runtime_error("Could not open file: " + paths[i]);
+
+                    file.size = st.st_size;
+                    file.next = 0;
+                    file.outstanding = 0;
+
+                    if (file.size == 0)
+                        finish(i);
+                    else
+                        reading.push_back(i);
+                    continue;
+                }
+
+                std::size_t i = reading.front();
+                PendingFile& file = files[i];
+
+                std::size_t r = freeReads.back();
+                freeReads.pop_back();
+
+                PendingRead& read = reads[r];
+                read.file = i;
+                read.chunk = file.chunks.size();
+                read.offset = file.next;
+                read.done = 0;
+
+                file.chunks.push_back(std::vector<char>(std::min(chunkSize, file.size - file.next)));
+                file.next += file.chunks.back().size();
+                file.outstanding++;
+                if (file.next >= file.size)
+                    reading.pop_front();
+
+                push(r);
+            }
+
+            if (inFlight == 0)
+                continue;
+
+            // The kernel may take fewer than asked; the rest stay queued
+            // for the next go.
+            int submitted = ring->submitAndWait(queued);
+            if (submitted < 0)
+                throw std::runtime_error(std::string("io_uring_enter failed: ") + std::strerror(errno));
+            queued -= static_cast<unsigned>(submitted);
+
+            unsigned long long data;
+            int res;
+            while (ring->pop(data, res)) {
+                inFlight--;
+
+                PendingRead& read = reads[data];
+                PendingFile& file = files[read.file];
+                std::vector<char>& chunk = file.chunks[read.chunk];
+
+                if (res < 0)
+                    throw std::runtime_error("Could not read file " + paths[read.file] + ": " + std::strerror(-res));
+
+                // A short read means either the rest is still to come, or the
+                // file shrank out from under us.
+                read.done += res;
+                if (res > 0 && read.done < chunk.size()) {
+                    push(data);
+                    continue;
+                }
+                chunk.resize(read.done);
+
+                freeReads.push_back(data);
+                if (--file.outstanding == 0 && file.next >= file.size)
+                    finish(read.file);
+            }
+        }
+    } catch (...) {
+        // The kernel may still be writing into our buffers, so everything in
+        // flight has to land before they can be freed.
+        int submitted;
+        while (inFlight > 0 && (submitted = ring->submitAndWait(queued)) >= 0) {
+            queued -= static_cast<unsigned>(submitted);
+
+            unsigned long long data;
+            int res;
+            while (ring->pop(data, res))
+                inFlight--;
+        }
+
+        for (PendingFile& file: files)
+            if (file.fd >= 0)
+                close(file.fd);
+        throw;
+    }
+}
+
+#else
+
+// Without io_uring there's nothing to hold on to.
+struct parsical::BatchFileReader::Ring { };
+
+// Reading the files with io_uring.
+void parsical::BatchFileReader::readRing(const std::vector<std::string>& paths, const std::function<void(std::size_t, parsical::ParseStream<char>&)>& fn) {
+    readFallback(paths, fn);
+}
+
+#endif
+
+// Reading the files one by one with an IStreamParser.
+void parsical::BatchFileReader::readFallback(const std::vector<std::string>& paths, const std::function<void(std::size_t, parsical::ParseStream<char>&)>& fn) {
+    for (std::size_t i = 0; i < paths.size(); i++) {
+        std::ifstream in(paths[i], std::ios::binary);
+        if (!in.good())
+            throw std::runtime_error("Could not open file: " + paths[i]);
+
+        parsical::IStreamParser stream(in);
+        fn(i, stream);
+    }
+}
+
+// Creating a BatchFileReader. If useIoUring is false, or io_uring
+// can't be set up, the fallback reader is used.
+parsical::BatchFileReader::BatchFileReader(std::size_t queueDepth, std::size_t chunkSize, bool useIoUring) :
+        queueDepth(std::max<std::size_t>(queueDepth, 1)),
+        chunkSize(std::max<std::size_t>(chunkSize, 1)) {
+#ifdef PARSICAL_HAVE_IO_URING
+    if (useIoUring) {
+        ring.reset(new Ring());
+        if (!ring->setup(this->queueDepth))
+            ring.reset();
+    }
+#endif
+}
+
+// Tearing down the io_uring, if there is one.
+parsical::BatchFileReader::~BatchFileReader() { }
+
+// Checking whether this reader is backed by io_uring.
+bool parsical::BatchFileReader::usingIoUring() const noexcept { return static_cast<bool>(ring); }
+
+// Reading every file in paths, and calling fn with the index of the
+// file and a stream over its contents as each one finishes. Files
+// finish in whatever order their reads complete. The stream is only
+// valid for the duration of the call. Throws a std::runtime_error if
+// a file can't be read, and passes on anything fn throws.
+void parsical::BatchFileReader::read(const std::vector<std::string>& paths, std::function<void(std::size_t, parsical::ParseStream<char>&)> fn) {
+    if (ring)
+        readRing(paths, fn);
+    else
+        readFallback(paths, fn);
+}
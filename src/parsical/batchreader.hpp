@@ -0,0 +1,67 @@
+// Name: parsical/batchreader.hpp
+//
+// Description:
+//   A reader for parsing many files in one go, keeping many reads in flight at
+//   once (through io_uring on Linux) instead of opening and reading each file
+//   with a blocking std::ifstream.
+
+#ifndef _PARSICAL_BATCH_READER_HPP_
+#define _PARSICAL_BATCH_READER_HPP_
+
+//////////////
+// Includes //
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "parsestream.hpp"
+
+//////////
+// Code //
+
+namespace parsical {
+    // Reads a batch of files with up to queueDepth reads of chunkSize bytes in
+    // flight across all of them. Every file is handed to a callback as soon as
+    // it has been read completely, as a SegmentedParser over its chunks.
+    //
+    // On kernels without io_uring (or when it is disabled, or blocked by a
+    // sandbox) it falls back to handing each file to the callback as a plain
+    // IStreamParser, one at a time.
+    class BatchFileReader {
+    private:
+        struct Ring;
+
+        std::unique_ptr<Ring> ring;
+        std::size_t queueDepth;
+        std::size_t chunkSize;
+
+        // Reading the files with io_uring.
+        void readRing(const std::vector<std::string>&, const std::function<void(std::size_t, ParseStream<char>&)>&);
+
+        // Reading the files one by one with an IStreamParser.
+        void readFallback(const std::vector<std::string>&, const std::function<void(std::size_t, ParseStream<char>&)>&);
+
+    public:
+        // Creating a BatchFileReader. If useIoUring is false, or io_uring
+        // can't be set up, the fallback reader is used.
+        BatchFileReader(std::size_t queueDepth = 32, std::size_t chunkSize = 1 << 17, bool useIoUring = true);
+
+        // Tearing down the io_uring, if there is one.
+        ~BatchFileReader();
+
+        // Checking whether this reader is backed by io_uring.
+        bool usingIoUring() const noexcept;
+
+        // Reading every file in paths, and calling fn with the index of the
+        // file and a stream over its contents as each one finishes. Files
+        // finish in whatever order their reads complete. The stream is only
+        // valid for the duration of the call. Throws a std::runtime_error if
+        // a file can't be read, and passes on anything fn throws.
+        void read(const std::vector<std::string>&, std::function<void(std::size_t, ParseStream<char>&)>);
+    };
+}
+
+#endif
@@ -0,0 +1,57 @@
+// Name: parsical/context.hpp
+//
+// Description:
+//   Per-parse state that travels along with a ParseStream, for combinators
+//   and user actions that need more than the stream itself.
+
+#ifndef _PARSICAL_CONTEXT_HPP_
+#define _PARSICAL_CONTEXT_HPP_
+
+//////////////
+// Includes //
+#include <stdexcept>
+#include <utility>
+
+#include "parsestream.hpp"
+#include "arena.hpp"
+
+//////////
+// Code //
+
+namespace parsical {
+    // See failures.hpp.
+    class FailureTracker;
+
+    // The mutable state of a single parse, other than the stream's position.
+    // A ParseContext is attached to a stream with ParseStream::setContext,
+    // and belongs to whichever thread is parsing that stream.
+    struct ParseContext {
+        // Where results get allocated. May be null, in which case results
+        // come from the global heap.
+        ParseArena* arena;
+
+        // Where failed alternatives get recorded. May be null, in which case
+        // they aren't.
+        FailureTracker* failures;
+
+        // Creating a ParseContext.
+        ParseContext(ParseArena* arena = nullptr, FailureTracker* failures = nullptr) :
+                arena(arena),
+                failures(failures) { }
+    };
+
+    // Getting the ParseArena attached to a stream. Throws if there isn't one.
+    template <typename ParserType>
+    ParseArena& arenaOf(ParseStream<ParserType>&) throw(std::runtime_error);
+
+    // Constructing a T in the ParseArena attached to a stream, e.g. for AST
+    // nodes built by user actions.
+    template <typename T,
+              typename ParserType,
+              typename... Args>
+    T* make(ParseStream<ParserType>&, Args&&...);
+}
+
+#include "context.tpp"
+
+#endif
@@ -0,0 +1,19 @@
+#include "context.hpp"
+
+// Getting the ParseArena attached to a stream. Throws if there isn't one.
+template <typename ParserType>
+parsical::ParseArena& parsical::arenaOf(parsical::ParseStream<ParserType>& stream) throw(std::runtime_error) {
+    parsical::ParseContext* context = stream.context();
+    if (context == nullptr || context->arena == nullptr)
+        throw std::runtime_error("No ParseArena is attached to this stream.");
+    return *context->arena;
+}
+
+// Constructing a T in the ParseArena attached to a stream, e.g. for AST
+// nodes built by user actions.
+template <typename T,
+          typename ParserType,
+          typename... Args>
+T* parsical::make(parsical::ParseStream<ParserType>& stream, Args&&... args) {
+    return parsical::arenaOf(stream).template make<T>(std::forward<Args>(args)...);
+}
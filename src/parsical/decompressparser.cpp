@@ -0,0 +1,322 @@
+#include "decompressparser.hpp"
+
+//////////////
+// Includes //
+#include <algorithm>
+#include <fstream>
+
+#ifdef PARSICAL_HAVE_ZLIB
+#include <zlib.h>
+#endif
+
+#ifdef PARSICAL_HAVE_ZSTD
+#include <zstd.h>
+#endif
+
+//////////
+// Code //
+
+// Reading the first block, working out the format and starting the
+// helper thread.
+void parsical::DecompressParser::start() throw(std::runtime_error) {
+    if (!in->good())
+        throw std::runtime_error("Input stream is not good.");
+
+    fill();
+    if (format == parsical::Compression::Auto) {
+        const unsigned char* magic = reinterpret_cast<const unsigned char*>(input.data());
+        if (buffered >= 4 && magic[0] == 0x28 && magic[1] == 0xb5 && magic[2] == 0x2f && magic[3] == 0xfd)
+            format = parsical::Compression::Zstd;
+        else
+            format = parsical::Compression::Gzip;
+    }
+
+    if (!supports(format))
+        throw std::runtime_error(format == parsical::Compression::Zstd ? "parsical was built without zstd." : "parsical was built without zlib.");
+
+    started = std::chrono::steady_clock::now();
+    if (format == parsical::Compression::Zstd)
+        worker = std::thread(&parsical::DecompressParser::zstdLoop, this);
+    else
+        worker = std::thread(&parsical::DecompressParser::gzipLoop, this);
+}
+
+// Reading the next block of compressed input. Returns how much was
+// read.
+std::size_t parsical::DecompressParser::fill() noexcept {
+    buffered = 0;
+    if (!in->good())
+        return 0;
+
+    in->read(input.data(), input.size());
+    buffered = static_cast<std::size_t>(in->gcount());
+    compressed += buffered;
+
+    return buffered;
+}
+
+// Giving up on the input with an error.
+void parsical::DecompressParser::fail(std::string message) noexcept {
+    error = message;
+    broken.store(true, std::memory_order_release);
+}
+
+// The helper thread's loops, one per format.
+void parsical::DecompressParser::gzipLoop() noexcept {
+#ifdef PARSICAL_HAVE_ZLIB
+    z_stream z;
+    z.zalloc = Z_NULL;
+    z.zfree = Z_NULL;
+    z.opaque = Z_NULL;
+    z.next_in = reinterpret_cast<Bytef*>(input.data());
+    z.avail_in = static_cast<uInt>(buffered);
+
+    // 15 bits of window, plus 32 to accept either a gzip or a zlib header.
+    if (inflateInit2(&z, 15 + 32) != Z_OK) {
+        fail("Could not start inflating.");
+        ring.close();
+        return;
+    }
+
+    // inflate can hold back output when the ring runs out of room, so input
+    // is only read once a call has left some of its output space unused.
+    bool inMember = z.avail_in > 0;
+    bool drained = true;
+    while (!stopping.load(std::memory_order_relaxed)) {
+        if (z.avail_in == 0 && drained) {
+            if (fill() == 0) {
+                if (inMember)
+                    fail("Compressed input is truncated.");
+                break;
+            }
+
+            z.next_in = reinterpret_cast<Bytef*>(input.data());
+            z.avail_in = static_cast<uInt>(buffered);
+            inMember = true;
+        }
+
+        char* at;
+        std::size_t n = std::min(ring.reserve(&at), blockSize);
+        if (n == 0) {
+            if (!ring.waitForSpace())
+                break;
+            continue;
+        }
+
+        z.next_out = reinterpret_cast<Bytef*>(at);
+        z.avail_out = static_cast<uInt>(n);
+
+        std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+        int ret = inflate(&z, Z_NO_FLUSH);
+        inflateNanos += std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count();
+
+        std::size_t produced = n - z.avail_out;
+        if (produced > 0) {
+            ring.commit(produced);
+            decompressed += produced;
+        }
+
+        drained = ret == Z_STREAM_END || z.avail_out > 0;
+        if (ret == Z_STREAM_END) {
+            // Another member may follow this one, possibly already buffered.
+            inflateReset(&z);
+            inMember = z.avail_in > 0;
+        } else if (ret != Z_OK && ret != Z_BUF_ERROR) {
+            fail(std::string("Corrupt compressed input: ") + (z.msg != nullptr ? z.msg : "unknown error."));
+            break;
+        }
+    }
+
+    inflateEnd(&z);
+#endif
+    ring.close();
+}
+
+void parsical::DecompressParser::zstdLoop() noexcept {
+#ifdef PARSICAL_HAVE_ZSTD
+    ZSTD_DStream* z = ZSTD_createDStream();
+    if (z == nullptr || ZSTD_isError(ZSTD_initDStream(z))) {
+        fail("Could not start decompressing.");
+        ZSTD_freeDStream(z);
+        ring.close();
+        return;
+    }
+
+    ZSTD_inBuffer source = { input.data(), buffered, 0 };
+    // As with gzip, a call that fills the output may still hold some back.
+    bool inFrame = buffered > 0;
+    bool drained = true;
+    while (!stopping.load(std::memory_order_relaxed)) {
+        if (source.pos == source.size && drained) {
+            if (fill() == 0) {
+                if (inFrame)
+                    fail("Compressed input is truncated.");
+                break;
+            }
+
+            source.src = input.data();
+            source.size = buffered;
+            source.pos = 0;
+            inFrame = true;
+        }
+
+        char* at;
+        std::size_t n = std::min(ring.reserve(&at), blockSize);
+        if (n == 0) {
+            if (!ring.waitForSpace())
+                break;
+            continue;
+        }
+
+        ZSTD_outBuffer target = { at, n, 0 };
+
+        std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+        std::size_t ret = ZSTD_decompressStream(z, &target, &source);
+        inflateNanos += std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count();
+
+        if (ZSTD_isError(ret)) {
+            fail(std::string("Corrupt compressed input: ") + ZSTD_getErrorName(ret));
+            break;
+        }
+
+        if (target.pos > 0) {
+            ring.commit(target.pos);
+            decompressed += target.pos;
+        }
+
+        // A return of 0 means a frame has been completely decoded and
+        // flushed; another may follow it.
+        inFrame = ret != 0;
+        drained = ret == 0 || target.pos < target.size;
+    }
+
+    ZSTD_freeDStream(z);
+#endif
+    ring.close();
+}
+
+// Throwing the helper thread's error, if it had one.
+void parsical::DecompressParser::check() const throw(parsical::ParseError) {
+    if (broken.load(std::memory_order_acquire))
+        throw parsical::ParseError(parsical::ErrorCode::Generic, error, pos());
+}
+
+// Creating a DecompressParser from a path to a compressed file.
+parsical::DecompressParser::DecompressParser(std::string path, parsical::Compression format, std::size_t blockSize, std::size_t depth) throw(std::runtime_error) :
+        owned(new std::ifstream(path, std::ios::binary)),
+        in(owned.get()),
+        format(format),
+        blockSize(blockSize),
+        input(blockSize),
+        buffered(0),
+        ring(blockSize * std::max<std::size_t>(depth, 2)),
+        parser(ring, blockSize),
+        stopping(false),
+        broken(false),
+        inflateNanos(0),
+        compressed(0),
+        decompressed(0) {
+    start();
+}
+
+// Creating a DecompressParser from an l-value reference istream. The
+// istream is read from the helper thread until this is destroyed.
+parsical::DecompressParser::DecompressParser(std::istream& in, parsical::Compression format, std::size_t blockSize, std::size_t depth) throw(std::runtime_error) :
+        in(&in),
+        format(format),
+        blockSize(blockSize),
+        input(blockSize),
+        buffered(0),
+        ring(blockSize * std::max<std::size_t>(depth, 2)),
+        parser(ring, blockSize),
+        stopping(false),
+        broken(false),
+        inflateNanos(0),
+        compressed(0),
+        decompressed(0) {
+    start();
+}
+
+// Stopping the helper thread.
+parsical::DecompressParser::~DecompressParser() {
+    stopping = true;
+    ring.abandon();
+    if (worker.joinable())
+        worker.join();
+}
+
+// Checking whether this build of parsical can read a format.
+bool parsical::DecompressParser::supports(parsical::Compression format) noexcept {
+    switch (format) {
+    case parsical::Compression::Gzip:
+#ifdef PARSICAL_HAVE_ZLIB
+        return true;
+#else
+        return false;
+#endif
+    case parsical::Compression::Zstd:
+#ifdef PARSICAL_HAVE_ZSTD
+        return true;
+#else
+        return false;
+#endif
+    default:
+        return supports(parsical::Compression::Gzip) || supports(parsical::Compression::Zstd);
+    }
+}
+
+// Getting the throughput so far.
+parsical::DecompressStats parsical::DecompressParser::stats() const noexcept {
+    double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - started).count();
+
+    parsical::DecompressStats s;
+    s.compressedBytes = compressed.load();
+    s.decompressedBytes = decompressed.load();
+    s.inflateSeconds = inflateNanos.load() / 1e9;
+    s.ioWaitSeconds = parser.waitSeconds();
+    s.compressedBytesPerSecond = elapsed > 0 ? s.compressedBytes / elapsed : 0;
+    s.decompressedBytesPerSecond = elapsed > 0 ? s.decompressedBytes / elapsed : 0;
+
+    return s;
+}
+
+// Checking whether this ParseStream has reached its end. Input that
+// stops early because it's corrupt or truncated hasn't: the next
+// read throws instead.
+bool parsical::DecompressParser::eof() const noexcept {
+    return parser.eof() && !broken.load(std::memory_order_acquire);
+}
+
+// Peeking at the next value without consuming it.
+char parsical::DecompressParser::peek() const throw(parsical::ParseError) {
+    if (parser.eof())
+        check();
+    return parser.peek();
+}
+
+// Getting the current position in this ParseStream.
+std::size_t parsical::DecompressParser::pos() const noexcept { return parser.pos(); }
+
+// Consuming and returning a value.
+char parsical::DecompressParser::get() throw(parsical::ParseError) {
+    if (parser.eof())
+        check();
+    return parser.get();
+}
+
+// Stepping back some interval.
+void parsical::DecompressParser::stepBack(std::size_t n) throw(parsical::ParseError) { parser.stepBack(n); }
+
+// Whether the compressed input has turned out to be corrupt or
+// truncated.
+bool parsical::DecompressParser::failed() const noexcept { return broken.load(std::memory_order_acquire); }
+
+// Making a cursor at the same position over the decompressed
+// buffer. It has to be used from the same thread as this parser, and
+// destroyed before it. Errors in the input are only reported by the
+// DecompressParser itself - to a fork, the input just ends early.
+std::unique_ptr<parsical::ParseStream<char>> parsical::DecompressParser::fork() const {
+    std::unique_ptr<parsical::ParseStream<char>> forked = parser.fork();
+    forked->setContext(context());
+    return forked;
+}
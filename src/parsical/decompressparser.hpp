@@ -0,0 +1,151 @@
+// Name: parsical/decompressparser.hpp
+//
+// Description:
+//   A ParseStream over compressed input, which is inflated on a helper thread
+//   straight into the parse window instead of to a temporary file.
+
+#ifndef _PARSICAL_DECOMPRESS_PARSER_HPP_
+#define _PARSICAL_DECOMPRESS_PARSER_HPP_
+
+//////////////
+// Includes //
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <istream>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "parsestream.hpp"
+#include "parseerror.hpp"
+#include "ringparser.hpp"
+
+//////////
+// Code //
+
+namespace parsical {
+    // The compression formats a DecompressParser understands. Gzip also
+    // covers raw zlib streams.
+    enum class Compression {
+        Auto,
+        Gzip,
+        Zstd
+    };
+
+    // How fast compressed input is being turned into parseable input.
+    struct DecompressStats {
+        // The number of compressed bytes read so far.
+        std::size_t compressedBytes;
+
+        // The number of bytes they've inflated to.
+        std::size_t decompressedBytes;
+
+        // Time the helper thread spent decompressing.
+        double inflateSeconds;
+
+        // Time the parser spent waiting for the helper thread.
+        double ioWaitSeconds;
+
+        // Bytes per second since the parser was made, on either side.
+        double compressedBytesPerSecond;
+        double decompressedBytesPerSecond;
+    };
+
+    // Like ReadAheadParser, but the helper thread decompresses as it reads.
+    // Compressed input is read blockSize bytes at a time and inflated straight
+    // into a RingBuffer of depth blocks, which the parser consumes from;
+    // stepping back is possible up to one block. Concatenated gzip members
+    // and zstd frames are read one after another.
+    //
+    // Which formats are available depends on the libraries found when
+    // parsical was built - see supports. Asking for one that isn't throws.
+    // Corrupt or truncated input shows up as a ParseError at the point the
+    // good data runs out, and from then on the parser reports that it has
+    // failed, so that combinators like many don't mistake it for the end.
+    class DecompressParser : public ParseStream<char> {
+    private:
+        std::unique_ptr<std::istream> owned;
+        std::istream* in;
+        Compression format;
+        std::size_t blockSize;
+        std::vector<char> input;
+        std::size_t buffered;
+        RingBuffer ring;
+        RingParser parser;
+        std::atomic<bool> stopping;
+        std::atomic<bool> broken;
+        std::string error;
+        std::atomic<long long> inflateNanos;
+        std::atomic<std::size_t> compressed;
+        std::atomic<std::size_t> decompressed;
+        std::chrono::steady_clock::time_point started;
+        std::thread worker;
+
+        // Reading the first block, working out the format and starting the
+        // helper thread.
+        void start() throw(std::runtime_error);
+
+        // Reading the next block of compressed input. Returns how much was
+        // read.
+        std::size_t fill() noexcept;
+
+        // Giving up on the input with an error.
+        void fail(std::string) noexcept;
+
+        // The helper thread's loops, one per format.
+        void gzipLoop() noexcept;
+        void zstdLoop() noexcept;
+
+        // Throwing the helper thread's error, if it had one.
+        void check() const throw(ParseError);
+
+    public:
+        // Creating a DecompressParser from a path to a compressed file.
+        DecompressParser(std::string, Compression format = Compression::Auto, std::size_t blockSize = 1 << 16, std::size_t depth = 4) throw(std::runtime_error);
+
+        // Creating a DecompressParser from an l-value reference istream. The
+        // istream is read from the helper thread until this is destroyed.
+        DecompressParser(std::istream&, Compression format = Compression::Auto, std::size_t blockSize = 1 << 16, std::size_t depth = 4) throw(std::runtime_error);
+
+        // Stopping the helper thread.
+        ~DecompressParser();
+
+        // Checking whether this build of parsical can read a format.
+        static bool supports(Compression) noexcept;
+
+        // Getting the throughput so far.
+        DecompressStats stats() const noexcept;
+
+        // Checking whether this ParseStream has reached its end. Input that
+        // stops early because it's corrupt or truncated hasn't: the next
+        // read throws instead.
+        virtual bool eof() const noexcept override;
+
+        // Peeking at the next value without consuming it.
+        virtual char peek() const throw(ParseError) override;
+
+        // Getting the current position in this ParseStream.
+        virtual std::size_t pos() const noexcept override;
+
+        // Consuming and returning a value.
+        virtual char get() throw(ParseError) override;
+
+        // Stepping back some interval.
+        virtual void stepBack(std::size_t) throw(ParseError) override;
+
+        // Whether the compressed input has turned out to be corrupt or
+        // truncated.
+        virtual bool failed() const noexcept override;
+
+        // Making a cursor at the same position over the decompressed
+        // buffer. It has to be used from the same thread as this parser, and
+        // destroyed before it. Errors in the input are only reported by the
+        // DecompressParser itself - to a fork, the input just ends early.
+        virtual std::unique_ptr<ParseStream<char>> fork() const override;
+    };
+}
+
+#endif
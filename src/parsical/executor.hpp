@@ -0,0 +1,38 @@
+// Name: parsical/executor.hpp
+//
+// Description:
+//   The interface parallel parsing functions use to run their work, so that
+//   the built-in ThreadPool can be swapped out for an existing scheduler.
+
+#ifndef _PARSICAL_EXECUTOR_HPP_
+#define _PARSICAL_EXECUTOR_HPP_
+
+//////////////
+// Includes //
+#include <cstddef>
+#include <functional>
+
+//////////
+// Code //
+
+namespace parsical {
+    // Something that can run a batch of indexed work across a fixed number of
+    // workers.
+    struct Executor {
+        // Virtual destructor to preemptively eliminate any problems with
+        // inherited deconstruction.
+        virtual ~Executor() { }
+
+        // The number of workers. Every worker index handed to run's function
+        // has to be less than this, and no two calls with the same worker
+        // index may overlap - that's what makes per-worker state safe.
+        virtual std::size_t size() const noexcept = 0;
+
+        // Calling fn(worker, index) for every index in [0, count), and
+        // waiting for all of them to finish. If any call throws, an exception
+        // is rethrown once everything is done.
+        virtual void run(std::size_t, std::function<void(std::size_t, std::size_t)>) = 0;
+    };
+}
+
+#endif
@@ -0,0 +1,100 @@
+#include "failures.hpp"
+
+////
+// TokenClasses
+
+// Adding a class, returning its bit. Throws once all 64 are taken.
+std::uint64_t parsical::TokenClasses::add(std::string name) throw(std::length_error) {
+    if (names.size() >= 64)
+        throw std::length_error("A TokenClasses can only hold 64 classes.");
+
+    names.push_back(name);
+    return std::uint64_t(1) << (names.size() - 1);
+}
+
+// Getting the name of a single bit.
+const std::string& parsical::TokenClasses::name(std::uint64_t bit) const throw(std::out_of_range) {
+    for (std::size_t i = 0; i < names.size(); i++)
+        if (bit == std::uint64_t(1) << i)
+            return names[i];
+    throw std::out_of_range("Not the bit of a known token class.");
+}
+
+// Describing a set of classes as "X, Y or Z".
+std::string parsical::TokenClasses::describe(std::uint64_t set) const {
+    std::vector<const std::string*> parts;
+    for (std::size_t i = 0; i < names.size(); i++)
+        if (set & (std::uint64_t(1) << i))
+            parts.push_back(&names[i]);
+
+    std::string str;
+    for (std::size_t i = 0; i < parts.size(); i++) {
+        if (i > 0)
+            str += i + 1 == parts.size() ? " or " : ", ";
+        str += *parts[i];
+    }
+
+    return str;
+}
+
+////
+// FailureTracker
+
+// Creating a FailureTracker that hasn't seen a failure.
+parsical::FailureTracker::FailureTracker() noexcept :
+        any(false),
+        farthest(0),
+        expectedSet(0) { }
+
+// Recording a failure at a position. Failures before the farthest one
+// are ignored, and ones at it add to what's expected there.
+void parsical::FailureTracker::fail(std::size_t position, std::uint64_t expected) noexcept {
+    if (!any || position > farthest) {
+        any = true;
+        farthest = position;
+        expectedSet = expected;
+    } else if (position == farthest) {
+        expectedSet |= expected;
+    }
+}
+
+// Forgetting every failure, to reuse the tracker for another parse.
+void parsical::FailureTracker::reset() noexcept {
+    any = false;
+    farthest = 0;
+    expectedSet = 0;
+}
+
+// Whether any failure has been recorded.
+bool parsical::FailureTracker::failed() const noexcept { return any; }
+
+// The farthest position a failure was recorded at, or
+// ParseError::npos.
+std::size_t parsical::FailureTracker::position() const noexcept {
+    return any ? farthest : parsical::ParseError::npos;
+}
+
+// The classes expected at the farthest failure.
+std::uint64_t parsical::FailureTracker::expected() const noexcept { return expectedSet; }
+
+// Describing the farthest failure as "expected X, Y or Z at
+// line:col", finding the line and column by scanning the input that
+// was parsed.
+std::string parsical::FailureTracker::report(const parsical::TokenClasses& classes, const char* data, std::size_t size) const {
+    if (!failed())
+        return "no failure";
+
+    parsical::LineIndex lines(data, size);
+    return report(classes, lines);
+}
+
+// The same as above, with a LineIndex that's already around - e.g. the
+// one belonging to a MappedFile.
+std::string parsical::FailureTracker::report(const parsical::TokenClasses& classes, parsical::LineIndex& lines) const {
+    if (!failed())
+        return "no failure";
+
+    parsical::LineCol at = lines.lineCol(farthest);
+    std::string what = expectedSet == 0 ? "unexpected input" : "expected " + classes.describe(expectedSet);
+    return what + " at " + std::to_string(at.line) + ":" + std::to_string(at.column);
+}
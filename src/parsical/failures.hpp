@@ -0,0 +1,110 @@
+// Name: parsical/failures.hpp
+//
+// Description:
+//   Keeping track of the farthest point a parse failed at, and what it would
+//   have accepted there, so one good error message can be made at the end.
+
+#ifndef _PARSICAL_FAILURES_HPP_
+#define _PARSICAL_FAILURES_HPP_
+
+//////////////
+// Includes //
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "parsestream.hpp"
+#include "parseerror.hpp"
+#include "context.hpp"
+#include "iteratorparser.hpp"
+#include "lineindex.hpp"
+
+//////////
+// Code //
+
+namespace parsical {
+    // Names for up to 64 classes of token - "digit", "identifier", "'('" and
+    // so on. Each class is a single bit, so a set of them fits in the
+    // expected set of a ParseError. A TokenClasses is built once alongside
+    // a grammar and only read while parsing.
+    class TokenClasses {
+    private:
+        std::vector<std::string> names;
+
+    public:
+        // Adding a class, returning its bit. Throws once all 64 are taken.
+        std::uint64_t add(std::string) throw(std::length_error);
+
+        // Getting the name of a single bit.
+        const std::string& name(std::uint64_t) const throw(std::out_of_range);
+
+        // Describing a set of classes as "X, Y or Z".
+        std::string describe(std::uint64_t) const;
+    };
+
+    // The farthest position any alternative failed at, and the union of the
+    // classes expected there. Recording a failure is a comparison and an or;
+    // nothing is formatted until report is called.
+    class FailureTracker {
+    private:
+        bool any;
+        std::size_t farthest;
+        std::uint64_t expectedSet;
+
+    public:
+        // Creating a FailureTracker that hasn't seen a failure.
+        FailureTracker() noexcept;
+
+        // Recording a failure at a position. Failures before the farthest one
+        // are ignored, and ones at it add to what's expected there.
+        void fail(std::size_t, std::uint64_t) noexcept;
+
+        // Forgetting every failure, to reuse the tracker for another parse.
+        void reset() noexcept;
+
+        // Whether any failure has been recorded.
+        bool failed() const noexcept;
+
+        // The farthest position a failure was recorded at, or
+        // ParseError::npos.
+        std::size_t position() const noexcept;
+
+        // The classes expected at the farthest failure.
+        std::uint64_t expected() const noexcept;
+
+        // Describing the farthest failure as "expected X, Y or Z at
+        // line:col", finding the line and column by scanning the input that
+        // was parsed.
+        std::string report(const TokenClasses&, const char*, std::size_t) const;
+
+        // The same as above, with a LineIndex that's already around - e.g. the
+        // one belonging to a MappedFile.
+        std::string report(const TokenClasses&, LineIndex&) const;
+    };
+
+    // Recording a failure in the FailureTracker attached to a stream, if there
+    // is one. Uses the error's position if it has one, and the given position
+    // otherwise.
+    template <typename ParserType>
+    void noteFailure(ParseStream<ParserType>&, const ParseError&, std::size_t) noexcept;
+
+    // Running a parser and, if it fails, reporting that the given classes were
+    // expected where it started - like parsec's <?>. The ParseError it
+    // rethrows carries the same expected set.
+    template <typename ReturnType,
+              typename ParserType,
+              typename FunctionType>
+    ReturnType label(ParseStream<ParserType>&, std::uint64_t, FunctionType) throw(ParseError);
+
+    // Parsing the whole of an input with a FailureTracker attached, and
+    // turning the farthest failure into a readable ParseError if it fails.
+    template <typename ReturnType,
+              typename FunctionType>
+    ReturnType parseWithDiagnostics(const std::string&, const TokenClasses&, FunctionType) throw(ParseError);
+}
+
+#include "failures.tpp"
+
+#endif
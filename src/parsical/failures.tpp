@@ -0,0 +1,55 @@
+#include "failures.hpp"
+
+// Recording a failure in the FailureTracker attached to a stream, if there
+// is one. Uses the error's position if it has one, and the given position
+// otherwise.
+template <typename ParserType>
+void parsical::noteFailure(parsical::ParseStream<ParserType>& stream, const parsical::ParseError& e, std::size_t pos) noexcept {
+    parsical::ParseContext* context = stream.context();
+    if (context == nullptr || context->failures == nullptr)
+        return;
+
+    context->failures->fail(e.position() != parsical::ParseError::npos ? e.position() : pos, e.expected());
+}
+
+// Running a parser and, if it fails, reporting that the given classes were
+// expected where it started - like parsec's <?>. The ParseError it
+// rethrows carries the same expected set.
+template <typename ReturnType,
+          typename ParserType,
+          typename FunctionType>
+ReturnType parsical::label(parsical::ParseStream<ParserType>& stream, std::uint64_t expected, FunctionType fn) throw(parsical::ParseError) {
+    std::size_t start = stream.pos();
+    try {
+        return fn(stream);
+    } catch (parsical::ParseError& e) {
+        // Something that got further than the start, or bad input, has a
+        // better idea of what went wrong than the label does.
+        if ((e.position() != parsical::ParseError::npos && e.position() > start) || stream.failed()) {
+            parsical::noteFailure(stream, e, start);
+            throw;
+        }
+
+        parsical::ParseError labelled(parsical::ErrorCode::Unexpected, "label: expected something else.", start, expected);
+        parsical::noteFailure(stream, labelled, start);
+        throw labelled;
+    }
+}
+
+// Parsing the whole of an input with a FailureTracker attached, and
+// turning the farthest failure into a readable ParseError if it fails.
+template <typename ReturnType,
+          typename FunctionType>
+ReturnType parsical::parseWithDiagnostics(const std::string& input, const parsical::TokenClasses& classes, FunctionType fn) throw(parsical::ParseError) {
+    parsical::FailureTracker failures;
+    parsical::ParseContext context(nullptr, &failures);
+    parsical::IteratorParser<const char*> stream(input.data(), input.data() + input.size());
+    stream.setContext(&context);
+
+    try {
+        return fn(stream);
+    } catch (parsical::ParseError& e) {
+        parsical::noteFailure(stream, e, stream.pos());
+        throw parsical::ParseError(e.code(), failures.report(classes, input.data(), input.size()), failures.position(), failures.expected());
+    }
+}
@@ -8,11 +8,15 @@
 
 //////////////
 // Includes //
+#include <functional>
+#include <memory>
 #include <vector>
 #include <set>
 
 #include "parsestream.hpp"
 #include "parseerror.hpp"
+#include "failures.hpp"
+#include "smallvector.hpp"
 
 //////////
 // Code //
@@ -26,18 +30,45 @@ namespace parsical {
               typename FunctionType>
     ReturnType tryParse(ParseStream<ParserType>&, FunctionType) throw(ParseError);
 
+    // The same as tryParse, named for use inside of choice: wrapping an
+    // alternative in attempt lets choice move on to the next one even if it
+    // consumed input before failing. Like tryParse, it won't rewind past a cut.
+    template <typename ReturnType,
+              typename ParserType,
+              typename FunctionType>
+    ReturnType attempt(ParseStream<ParserType>&, FunctionType) throw(ParseError);
+
+    // Committing to everything parsed so far - see ParseStream::cut. Failures
+    // after a cut can't be backtracked out of past the cut, and the stream can
+    // let go of the input before it.
+    template <typename ParserType>
+    void cut(ParseStream<ParserType>&) noexcept;
+
     // Getting a vector of whatever the ParserType is based on some predicate.
     // If the end of the stream is reached, it just returns all recorded values.
     template <typename ParserType,
               typename FunctionType>
     std::vector<ParserType> takeWhile(ParseStream<ParserType>&, FunctionType);
 
+    // An allocator-aware version of takeWhile. The returned vector allocates
+    // with a copy of the given allocator, e.g. an ArenaAllocator.
+    template <typename ParserType,
+              typename FunctionType,
+              typename Allocator>
+    std::vector<ParserType, Allocator> takeWhile(ParseStream<ParserType>&, FunctionType, const Allocator&);
+
     // The inverse of takeWhile - so long as a predicate is not true, it will
     // take a new value.
     template <typename ParserType,
               typename FunctionType>
     std::vector<ParserType> takeUntil(ParseStream<ParserType>&, FunctionType);
 
+    // An allocator-aware version of takeUntil.
+    template <typename ParserType,
+              typename FunctionType,
+              typename Allocator>
+    std::vector<ParserType, Allocator> takeUntil(ParseStream<ParserType>&, FunctionType, const Allocator&);
+
     // Ignoring characters in a stream while a predicate is true. It stops when
     // the predicate fails to be true for a character, or when the end of the
     // stream is reached.
@@ -70,6 +101,13 @@ namespace parsical {
               typename FunctionType>
     std::vector<ReturnType> many(ParseStream<ParserType>&, FunctionType) throw(ParseError);
 
+    // An allocator-aware version of many.
+    template <typename ReturnType,
+              typename ParserType,
+              typename FunctionType,
+              typename Allocator>
+    std::vector<ReturnType, Allocator> many(ParseStream<ParserType>&, FunctionType, const Allocator&) throw(ParseError);
+
     // Attempting to match many of a function on a parser. Will fail if no parses
     // succeed.
     template <typename ReturnType,
@@ -77,13 +115,68 @@ namespace parsical {
               typename FunctionType>
     std::vector<ReturnType> manyOne(ParseStream<ParserType>&, FunctionType) throw(ParseError);
 
+    // An allocator-aware version of manyOne.
+    template <typename ReturnType,
+              typename ParserType,
+              typename FunctionType,
+              typename Allocator>
+    std::vector<ReturnType, Allocator> manyOne(ParseStream<ParserType>&, FunctionType, const Allocator&) throw(ParseError);
+
+    // A version of many for results that are usually short. The first N
+    // values are kept inside of the returned SmallVector, so they don't
+    // allocate.
+    template <typename ReturnType,
+              std::size_t N,
+              typename ParserType,
+              typename FunctionType>
+    SmallVector<ReturnType, N> manySmall(ParseStream<ParserType>&, FunctionType) throw(ParseError);
+
+    // A version of manyOne that returns a SmallVector.
+    template <typename ReturnType,
+              std::size_t N,
+              typename ParserType,
+              typename FunctionType>
+    SmallVector<ReturnType, N> manyOneSmall(ParseStream<ParserType>&, FunctionType) throw(ParseError);
+
+    // Matching a function exactly n times. The result is allocated once, up
+    // front. Fails if any of the n parses does.
+    template <typename ReturnType,
+              typename ParserType,
+              typename FunctionType>
+    std::vector<ReturnType> count(ParseStream<ParserType>&, std::size_t, FunctionType) throw(ParseError);
+
+    // Running a parser without consuming any input, and returning what it
+    // parsed. Streams that can always rewind run it in place and step back;
+    // others run it on a fork if they can make one, and in place if not.
+    template <typename ReturnType,
+              typename ParserType,
+              typename FunctionType>
+    ReturnType lookAhead(ParseStream<ParserType>&, FunctionType) throw(ParseError);
+
+    // Succeeding, without consuming any input, only if a parser fails at the
+    // current position.
+    template <typename ParserType,
+              typename FunctionType>
+    void notFollowedBy(ParseStream<ParserType>&, FunctionType) throw(ParseError);
+
+    // A committed choice between functions, like parsec's <|>. An
+    // alternative that fails without consuming input moves on to the next
+    // one, but one that fails after consuming input fails the whole choice,
+    // without rewinding. Wrap an alternative in attempt to have it rewind.
+    // For the fully backtracking kind, see option, or alternatives for
+    // Grammars.
+    template <typename ReturnType,
+              typename ParserType,
+              typename FunctionType>
+    ReturnType choice(ParseStream<ParserType>&, const std::vector<FunctionType>&) throw(ParseError);
+
     // Option takes a series of possible functions. It returns the value of the
     // first successful parse. If nothing is successfully parsed - the stream
     // consumes no input.
     template <typename ReturnType,
               typename ParserType,
               typename FunctionType>
-    ReturnType option(ParseStream<ParserType>&, std::vector<FunctionType>) throw(ParseError);
+    ReturnType option(ParseStream<ParserType>&, const std::vector<FunctionType>&) throw(ParseError);
 }
 
 #include "general.tpp"
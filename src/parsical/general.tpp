@@ -7,15 +7,39 @@ template <typename ReturnType,
           typename ParserType,
           typename FunctionType>
 ReturnType parsical::tryParse(parsical::ParseStream<ParserType>& stream, FunctionType fn) throw(ParseError) {
-    int pos = stream.pos();
+    std::size_t pos = stream.pos();
     try {
         return fn(stream);
     } catch (ParseError& e) {
+        parsical::noteFailure(stream, e, stream.pos());
+
+        // There's no going back past a cut, so the failure stands.
+        if (pos < stream.lastCut())
+            throw;
+
         stream.stepBack(stream.pos() - pos);
-        throw e;
+        throw;
     }
 }
 
+// The same as tryParse, named for use inside of choice: wrapping an
+// alternative in attempt lets choice move on to the next one even if it
+// consumed input before failing. Like tryParse, it won't rewind past a cut.
+template <typename ReturnType,
+          typename ParserType,
+          typename FunctionType>
+ReturnType parsical::attempt(parsical::ParseStream<ParserType>& stream, FunctionType fn) throw(parsical::ParseError) {
+    return parsical::tryParse<ReturnType>(stream, fn);
+}
+
+// Committing to everything parsed so far - see ParseStream::cut. Failures
+// after a cut can't be backtracked out of past the cut, and the stream can
+// let go of the input before it.
+template <typename ParserType>
+void parsical::cut(parsical::ParseStream<ParserType>& stream) noexcept {
+    stream.cut();
+}
+
 // Getting a vector of whatever the ParserType is based on some predicate.
 // If the end of the stream is reached, it just returns all recorded values.
 template <typename ParserType,
@@ -29,6 +53,20 @@ std::vector<ParserType> parsical::takeWhile(parsical::ParseStream<ParserType>& s
     return ret;
 }
 
+// An allocator-aware version of takeWhile. The returned vector allocates
+// with a copy of the given allocator, e.g. an ArenaAllocator.
+template <typename ParserType,
+          typename FunctionType,
+          typename Allocator>
+std::vector<ParserType, Allocator> parsical::takeWhile(parsical::ParseStream<ParserType>& stream, FunctionType fn, const Allocator& alloc) {
+    std::vector<ParserType, Allocator> ret(alloc);
+
+    while (!stream.eof() && fn(stream.peek()))
+        ret.push_back(stream.get());
+
+    return ret;
+}
+
 // The inerse of takeWhile - so long as a predicate is not true, it will
 // take a new value.
 template <typename ParserType,
@@ -42,6 +80,19 @@ std::vector<ParserType> parsical::takeUntil(parsical::ParseStream<ParserType>& s
     return ret;
 }
 
+// An allocator-aware version of takeUntil.
+template <typename ParserType,
+          typename FunctionType,
+          typename Allocator>
+std::vector<ParserType, Allocator> parsical::takeUntil(parsical::ParseStream<ParserType>& stream, FunctionType fn, const Allocator& alloc) {
+    std::vector<ParserType, Allocator> ret(alloc);
+
+    while (!stream.eof() && !fn(stream.peek()))
+        ret.push_back(stream.get());
+
+    return ret;
+}
+
 // Ignoring characters in a stream while a predicate is true. It stops when
 // the predicate fails to be true for a character, or when the end of the
 // stream is reached.
@@ -67,7 +118,7 @@ void parsical::dropUntil(parsical::ParseStream<ParserType>& stream, FunctionType
 template <typename ParserType>
 ParserType parsical::oneOf(parsical::ParseStream<ParserType>& stream, const std::set<ParserType>& set) throw(parsical::ParseError) {
     if (set.find(stream.peek()) == set.end())
-        throw parsical::ParseError("Value is not in the set of appropriate values.");
+        throw parsical::ParseError(parsical::ErrorCode::Unexpected, "Value is not in the set of appropriate values.", stream.pos());
     return stream.get();
 }
 
@@ -78,7 +129,7 @@ ParserType parsical::oneOf(parsical::ParseStream<ParserType>& stream, const std:
 template <typename ParserType>
 ParserType parsical::noneOf(parsical::ParseStream<ParserType>& stream, const std::set<ParserType>& set) throw(parsical::ParseError) {
     if (set.find(stream.peek()) != set.end())
-        throw parsical::ParseError("Value is in the set of inappropriate values.");
+        throw parsical::ParseError(parsical::ErrorCode::Unexpected, "Value is in the set of inappropriate values.", stream.pos());
     return stream.get();
 }
 
@@ -93,7 +144,33 @@ std::vector<ReturnType> parsical::many(parsical::ParseStream<ParserType>& stream
     while (good) {
         try {
             values.push_back(fn(stream));
-        } catch (parsical::ParseError& e) { good = false; }
+        } catch (parsical::ParseError& e) {
+            if (stream.failed())
+                throw;
+            good = false;
+        }
+    }
+
+    return values;
+}
+
+// An allocator-aware version of many.
+template <typename ReturnType,
+          typename ParserType,
+          typename FunctionType,
+          typename Allocator>
+std::vector<ReturnType, Allocator> parsical::many(parsical::ParseStream<ParserType>& stream, FunctionType fn, const Allocator& alloc) throw(parsical::ParseError) {
+    std::vector<ReturnType, Allocator> values(alloc);
+
+    bool good = true;
+    while (good) {
+        try {
+            values.push_back(fn(stream));
+        } catch (parsical::ParseError& e) {
+            if (stream.failed())
+                throw;
+            good = false;
+        }
     }
 
     return values;
@@ -107,21 +184,166 @@ template <typename ReturnType,
 std::vector<ReturnType> parsical::manyOne(parsical::ParseStream<ParserType>& stream, FunctionType fn) throw(parsical::ParseError) {
     std::vector<ReturnType> values = parsical::many<ReturnType>(stream, fn);
     if (values.size() == 0)
-        throw parsical::ParseError("manyOne: no parses succeeded.");
+        throw parsical::ParseError(parsical::ErrorCode::NoMatch, "manyOne: no parses succeeded.", stream.pos());
+    return values;
+}
+
+// An allocator-aware version of manyOne.
+template <typename ReturnType,
+          typename ParserType,
+          typename FunctionType,
+          typename Allocator>
+std::vector<ReturnType, Allocator> parsical::manyOne(parsical::ParseStream<ParserType>& stream, FunctionType fn, const Allocator& alloc) throw(parsical::ParseError) {
+    std::vector<ReturnType, Allocator> values = parsical::many<ReturnType>(stream, fn, alloc);
+    if (values.size() == 0)
+        throw parsical::ParseError(parsical::ErrorCode::NoMatch, "manyOne: no parses succeeded.", stream.pos());
     return values;
 }
 
+// A version of many for results that are usually short. The first N
+// values are kept inside of the returned SmallVector, so they don't
+// allocate.
+template <typename ReturnType,
+          std::size_t N,
+          typename ParserType,
+          typename FunctionType>
+parsical::SmallVector<ReturnType, N> parsical::manySmall(parsical::ParseStream<ParserType>& stream, FunctionType fn) throw(parsical::ParseError) {
+    parsical::SmallVector<ReturnType, N> values;
+
+    bool good = true;
+    while (good) {
+        try {
+            values.push_back(fn(stream));
+        } catch (parsical::ParseError& e) {
+            if (stream.failed())
+                throw;
+            good = false;
+        }
+    }
+
+    return values;
+}
+
+// A version of manyOne that returns a SmallVector.
+template <typename ReturnType,
+          std::size_t N,
+          typename ParserType,
+          typename FunctionType>
+parsical::SmallVector<ReturnType, N> parsical::manyOneSmall(parsical::ParseStream<ParserType>& stream, FunctionType fn) throw(parsical::ParseError) {
+    parsical::SmallVector<ReturnType, N> values = parsical::manySmall<ReturnType, N>(stream, fn);
+    if (values.size() == 0)
+        throw parsical::ParseError(parsical::ErrorCode::NoMatch, "manyOneSmall: no parses succeeded.", stream.pos());
+    return values;
+}
+
+// Matching a function exactly n times. The result is allocated once, up
+// front. Fails if any of the n parses does.
+template <typename ReturnType,
+          typename ParserType,
+          typename FunctionType>
+std::vector<ReturnType> parsical::count(parsical::ParseStream<ParserType>& stream, std::size_t n, FunctionType fn) throw(parsical::ParseError) {
+    std::vector<ReturnType> values;
+    values.reserve(n);
+
+    for (std::size_t i = 0; i < n; i++)
+        values.push_back(fn(stream));
+
+    return values;
+}
+
+// Running a parser without consuming any input, and returning what it
+// parsed. Streams that can always rewind run it in place and step back;
+// others run it on a fork if they can make one, and in place if not.
+template <typename ReturnType,
+          typename ParserType,
+          typename FunctionType>
+ReturnType parsical::lookAhead(parsical::ParseStream<ParserType>& stream, FunctionType fn) throw(parsical::ParseError) {
+    std::unique_ptr<parsical::ParseStream<ParserType>> forked;
+    if (!stream.rewindable())
+        forked = stream.fork();
+    if (forked)
+        return fn(*forked);
+
+    std::size_t start = stream.pos();
+    ReturnType value = parsical::tryParse<ReturnType>(stream, fn);
+    stream.stepBack(stream.pos() - start);
+
+    return value;
+}
+
+// Succeeding, without consuming any input, only if a parser fails at the
+// current position.
+template <typename ParserType,
+          typename FunctionType>
+void parsical::notFollowedBy(parsical::ParseStream<ParserType>& stream, FunctionType fn) throw(parsical::ParseError) {
+    std::size_t start = stream.pos();
+    std::unique_ptr<parsical::ParseStream<ParserType>> forked;
+    if (!stream.rewindable())
+        forked = stream.fork();
+    parsical::ParseStream<ParserType>& cursor = forked ? *forked : stream;
+
+    try {
+        fn(cursor);
+    } catch (parsical::ParseError& e) {
+        if (stream.failed())
+            throw;
+        if (!forked)
+            stream.stepBack(stream.pos() - start);
+        return;
+    }
+
+    if (!forked)
+        stream.stepBack(stream.pos() - start);
+    throw parsical::ParseError(parsical::ErrorCode::Unexpected, "notFollowedBy: the parser succeeded.", start);
+}
+
+// A committed choice between functions, like parsec's <|>. An
+// alternative that fails without consuming input moves on to the next
+// one, but one that fails after consuming input fails the whole choice,
+// without rewinding. Wrap an alternative in attempt to have it rewind.
+// For the fully backtracking kind, see option, or alternatives for
+// Grammars.
+template <typename ReturnType,
+          typename ParserType,
+          typename FunctionType>
+ReturnType parsical::choice(parsical::ParseStream<ParserType>& stream, const std::vector<FunctionType>& fns) throw(parsical::ParseError) {
+    std::size_t start = stream.pos();
+    std::uint64_t expected = 0;
+    for (const FunctionType& fn: fns) {
+        try { return fn(stream); }
+        catch (parsical::ParseError& e) {
+            parsical::noteFailure(stream, e, stream.pos());
+            if (stream.pos() != start || stream.failed())
+                throw;
+            expected |= e.expected();
+        }
+    }
+
+    throw parsical::ParseError(parsical::ErrorCode::NoMatch, "choice: no function matched.", start, expected);
+}
+
 // Option takes a series of possible functions. It returns the value of the
 // first successful parse. If nothing is successfully parsed - the stream
 // consumes no input.
 template <typename ReturnType,
           typename ParserType,
           typename FunctionType>
-ReturnType parsical::option(parsical::ParseStream<ParserType>& stream, std::vector<FunctionType> fns) throw(parsical::ParseError) {
-    for (FunctionType fn: fns) {
-        try { return tryParse<ReturnType>(stream, fn); }
-        catch (parsical::ParseError& e) { }
+ReturnType parsical::option(parsical::ParseStream<ParserType>& stream, const std::vector<FunctionType>& fns) throw(parsical::ParseError) {
+    // Alternatives that fail without getting anywhere all add to what was
+    // expected here.
+    std::size_t start = stream.pos();
+    std::uint64_t expected = 0;
+    for (const FunctionType& fn: fns) {
+        try { return tryParse<ReturnType>(stream, std::cref(fn)); }
+        catch (parsical::ParseError& e) {
+            // An alternative that got past a cut can't be undone, and
+            // neither can bad input.
+            if (stream.pos() != start || stream.failed())
+                throw;
+            if (e.position() == parsical::ParseError::npos || e.position() <= start)
+                expected |= e.expected();
+        }
     }
 
-    throw parsical::ParseError("option: no function matched.");
+    throw parsical::ParseError(parsical::ErrorCode::NoMatch, "option: no function matched.", start, expected);
 }
@@ -0,0 +1,16 @@
+#include "grammar.hpp"
+
+//////////////
+// Includes //
+#include "string.hpp"
+
+//////////
+// Code //
+
+// A Grammar that matches a specific string, in the same way as
+// str::string.
+parsical::Grammar<std::string> parsical::literal(std::string str) {
+    return parsical::Grammar<std::string>([str](parsical::ParseStream<char>& stream) -> std::string {
+        return parsical::str::string(stream, str);
+    });
+}
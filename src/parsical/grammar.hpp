@@ -0,0 +1,78 @@
+// Name: parsical/grammar.hpp
+//
+// Description:
+//   Compiled, immutable parser objects. A Grammar is built once and can then
+//   be shared by, and called from, any number of threads at the same time.
+
+#ifndef _PARSICAL_GRAMMAR_HPP_
+#define _PARSICAL_GRAMMAR_HPP_
+
+//////////////
+// Includes //
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "parsestream.hpp"
+#include "parseerror.hpp"
+#include "general.hpp"
+
+//////////
+// Code //
+
+namespace parsical {
+    // A parser that has already been put together. Copying a Grammar is
+    // cheap, since the copies all share the same underlying function. None
+    // of them can change it, so every bit of mutable state in a parse lives
+    // in the ParseStream it's run on.
+    template <typename ReturnType,
+              typename ParserType = char>
+    class Grammar {
+    public:
+        typedef std::function<ReturnType(ParseStream<ParserType>&)> Function;
+
+    private:
+        std::shared_ptr<const Function> fn;
+
+    public:
+        // Compiling a Grammar out of a parsing function. The function must
+        // not change any state of its own when it's called.
+        Grammar(Function);
+
+        // Running the Grammar on a stream.
+        ReturnType operator()(ParseStream<ParserType>&) const throw(ParseError);
+
+        // Running the Grammar on a stream.
+        ReturnType parse(ParseStream<ParserType>&) const throw(ParseError);
+    };
+
+    // A Grammar that matches a specific string, in the same way as
+    // str::string.
+    Grammar<std::string> literal(std::string);
+
+    // A Grammar that tries each of the given Grammars in turn, in the same
+    // way as option. Unlike the choice combinator, it always backtracks: an
+    // alternative that fails after consuming input is rewound, and the next
+    // one is tried (short of a cut).
+    template <typename ReturnType,
+              typename ParserType>
+    Grammar<ReturnType, ParserType> alternatives(std::vector<Grammar<ReturnType, ParserType>>);
+
+    // A Grammar that matches another Grammar as many times as it can, in the
+    // same way as many.
+    template <typename ReturnType,
+              typename ParserType>
+    Grammar<std::vector<ReturnType>, ParserType> manyOf(Grammar<ReturnType, ParserType>);
+
+    // A Grammar that passes the result of another Grammar through a
+    // function.
+    template <typename NewType,
+              typename ReturnType,
+              typename ParserType>
+    Grammar<NewType, ParserType> transform(Grammar<ReturnType, ParserType>, std::function<NewType(ReturnType)>);
+}
+
+#include "grammar.tpp"
+
+#endif
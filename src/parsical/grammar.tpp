@@ -0,0 +1,55 @@
+#include "grammar.hpp"
+
+// Compiling a Grammar out of a parsing function. The function must
+// not change any state of its own when it's called.
+template <typename ReturnType,
+          typename ParserType>
+parsical::Grammar<ReturnType, ParserType>::Grammar(Function fn) :
+        fn(std::make_shared<const Function>(fn)) { }
+
+// Running the Grammar on a stream.
+template <typename ReturnType,
+          typename ParserType>
+ReturnType parsical::Grammar<ReturnType, ParserType>::operator()(parsical::ParseStream<ParserType>& stream) const throw(parsical::ParseError) {
+    return (*fn)(stream);
+}
+
+// Running the Grammar on a stream.
+template <typename ReturnType,
+          typename ParserType>
+ReturnType parsical::Grammar<ReturnType, ParserType>::parse(parsical::ParseStream<ParserType>& stream) const throw(parsical::ParseError) {
+    return (*fn)(stream);
+}
+
+// A Grammar that tries each of the given Grammars in turn, in the same
+// way as option. Unlike the choice combinator, it always backtracks: an
+// alternative that fails after consuming input is rewound, and the next
+// one is tried (short of a cut).
+template <typename ReturnType,
+          typename ParserType>
+parsical::Grammar<ReturnType, ParserType> parsical::alternatives(std::vector<parsical::Grammar<ReturnType, ParserType>> grammars) {
+    return parsical::Grammar<ReturnType, ParserType>([grammars](parsical::ParseStream<ParserType>& stream) -> ReturnType {
+        return parsical::option<ReturnType>(stream, grammars);
+    });
+}
+
+// A Grammar that matches another Grammar as many times as it can, in the
+// same way as many.
+template <typename ReturnType,
+          typename ParserType>
+parsical::Grammar<std::vector<ReturnType>, ParserType> parsical::manyOf(parsical::Grammar<ReturnType, ParserType> grammar) {
+    return parsical::Grammar<std::vector<ReturnType>, ParserType>([grammar](parsical::ParseStream<ParserType>& stream) -> std::vector<ReturnType> {
+        return parsical::many<ReturnType>(stream, grammar);
+    });
+}
+
+// A Grammar that passes the result of another Grammar through a
+// function.
+template <typename NewType,
+          typename ReturnType,
+          typename ParserType>
+parsical::Grammar<NewType, ParserType> parsical::transform(parsical::Grammar<ReturnType, ParserType> grammar, std::function<NewType(ReturnType)> fn) {
+    return parsical::Grammar<NewType, ParserType>([grammar, fn](parsical::ParseStream<ParserType>& stream) -> NewType {
+        return fn(grammar(stream));
+    });
+}
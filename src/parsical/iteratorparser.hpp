@@ -0,0 +1,229 @@
+// Name: parsical/iteratorparser.hpp
+//
+// Description:
+//   A ParseStream implementation that parses in place over an arbitrary
+//   iterator range, so containers like std::deque or ring buffers don't have
+//   to be copied into a std::string first.
+
+#ifndef _PARSICAL_ITERATOR_PARSER_HPP_
+#define _PARSICAL_ITERATOR_PARSER_HPP_
+
+//////////////
+// Includes //
+#include <algorithm>
+#include <cstddef>
+#include <deque>
+#include <iterator>
+#include <memory>
+#include <type_traits>
+#include <vector>
+
+#include "parsestream.hpp"
+#include "parseerror.hpp"
+
+//////////
+// Code //
+
+namespace parsical {
+    // A parser over a pair of iterators. The general case works on any
+    // single-pass input iterator by keeping a replay buffer of the values it
+    // has pulled off of the range, so that stepping back never has to touch
+    // the underlying iterator again. Values before the last cut or
+    // discardBefore are dropped from the buffer.
+    template <typename It,
+              typename Category = typename std::iterator_traits<It>::iterator_category>
+    class IteratorParser : public ParseStream<typename std::iterator_traits<It>::value_type> {
+    public:
+        typedef typename std::iterator_traits<It>::value_type value_type;
+
+    private:
+        std::deque<value_type> replay;
+        std::size_t base;
+        It cur, end;
+        std::size_t p;
+
+    public:
+        // Constructing an IteratorParser from the range [begin, end).
+        IteratorParser(It, It);
+
+        // Checking whether this ParseStream has reached its end.
+        virtual bool eof() const noexcept override;
+
+        // Peeking at the next value without consuming it.
+        virtual value_type peek() const throw(ParseError) override;
+
+        // Getting the current position in this ParseStream.
+        virtual std::size_t pos() const noexcept override;
+
+        // Consuming and returning a value.
+        virtual value_type get() throw(ParseError) override;
+
+        // Stepping back some interval.
+        virtual void stepBack(std::size_t) throw(ParseError) override;
+
+        // Dropping the replayed values before the given position.
+        virtual void discardBefore(std::size_t) noexcept override;
+    };
+
+    // The forward iterator specialization. Forward iterators can be copied
+    // and walked again, so instead of buffering values this keeps a copy of
+    // the iterator every checkpointInterval positions, and steps back by
+    // walking forward from the nearest one.
+    template <typename It>
+    class IteratorParser<It, std::forward_iterator_tag> : public ParseStream<typename std::iterator_traits<It>::value_type> {
+    public:
+        typedef typename std::iterator_traits<It>::value_type value_type;
+
+        // How far apart the saved iterators are.
+        static constexpr std::size_t checkpointInterval = 64;
+
+    private:
+        std::deque<It> checkpoints;
+        std::size_t firstCheckpoint;
+        std::size_t discarded;
+        It cur, end;
+        std::size_t p;
+
+    public:
+        // Constructing an IteratorParser from the range [begin, end).
+        IteratorParser(It, It);
+
+        // Checking whether this ParseStream has reached its end.
+        virtual bool eof() const noexcept override;
+
+        // Peeking at the next value without consuming it.
+        virtual value_type peek() const throw(ParseError) override;
+
+        // Getting the current position in this ParseStream.
+        virtual std::size_t pos() const noexcept override;
+
+        // Consuming and returning a value.
+        virtual value_type get() throw(ParseError) override;
+
+        // Stepping back some interval.
+        virtual void stepBack(std::size_t) throw(ParseError) override;
+
+        // Dropping the saved iterators before the given position.
+        virtual void discardBefore(std::size_t) noexcept override;
+
+        // Making an IteratorParser at the same position over the same range.
+        // The range isn't copied, so it has to outlive every fork.
+        virtual std::unique_ptr<ParseStream<value_type>> fork() const override;
+    };
+
+    // The bidirectional iterator specialization. Stepping back just walks the
+    // iterator backwards, so nothing needs to be kept at all.
+    template <typename It>
+    class IteratorParser<It, std::bidirectional_iterator_tag> : public ParseStream<typename std::iterator_traits<It>::value_type> {
+    public:
+        typedef typename std::iterator_traits<It>::value_type value_type;
+
+    private:
+        It cur, end;
+        std::size_t p;
+
+    public:
+        // Constructing an IteratorParser from the range [begin, end).
+        IteratorParser(It, It);
+
+        // Checking whether this ParseStream has reached its end.
+        virtual bool eof() const noexcept override;
+
+        // Peeking at the next value without consuming it.
+        virtual value_type peek() const throw(ParseError) override;
+
+        // Getting the current position in this ParseStream.
+        virtual std::size_t pos() const noexcept override;
+
+        // Consuming and returning a value.
+        virtual value_type get() throw(ParseError) override;
+
+        // Stepping back some interval.
+        virtual void stepBack(std::size_t) throw(ParseError) override;
+
+        // Whether any earlier position can be stepped back to.
+        virtual bool rewindable() const noexcept override;
+
+        // Making an IteratorParser at the same position over the same range.
+        // The range isn't copied, so it has to outlive every fork.
+        virtual std::unique_ptr<ParseStream<value_type>> fork() const override;
+    };
+
+    // The random-access specialization. Nothing needs to be buffered, and both
+    // pos and stepBack are plain iterator arithmetic.
+    template <typename It>
+    class IteratorParser<It, std::random_access_iterator_tag> : public ParseStream<typename std::iterator_traits<It>::value_type> {
+    public:
+        typedef typename std::iterator_traits<It>::value_type value_type;
+
+    private:
+        It begin, cur, end;
+        std::size_t base;
+        std::vector<value_type> scratch;
+
+        // Looking at the next n values. Pointers can hand out a view
+        // directly; other iterators are copied into scratch.
+        Span<value_type> peekNFrom(std::size_t, std::true_type) throw(ParseError);
+        Span<value_type> peekNFrom(std::size_t, std::false_type) throw(ParseError);
+
+    public:
+        // Constructing an IteratorParser from the range [begin, end). The
+        // optional base is added to every position reported, for when the
+        // range is a piece of some larger input.
+        IteratorParser(It, It, std::size_t base = 0);
+
+        // Pointing this IteratorParser at a new range, so that it can be
+        // reused without being reconstructed.
+        void reset(It, It, std::size_t base = 0) noexcept;
+
+        // Checking whether this ParseStream has reached its end.
+        virtual bool eof() const noexcept override;
+
+        // Peeking at the next value without consuming it.
+        virtual value_type peek() const throw(ParseError) override;
+
+        // Getting the current position in this ParseStream.
+        virtual std::size_t pos() const noexcept override;
+
+        // Consuming and returning a value.
+        virtual value_type get() throw(ParseError) override;
+
+        // Stepping back some interval.
+        virtual void stepBack(std::size_t) throw(ParseError) override;
+
+        // Whether ensure, peekN and advance work on a buffer.
+        virtual bool buffered() const noexcept override;
+
+        // Whether any earlier position can be stepped back to.
+        virtual bool rewindable() const noexcept override;
+
+        // Checking that at least n more values are available.
+        virtual bool ensure(std::size_t) override;
+
+        // Looking at the next n values without consuming them.
+        virtual Span<value_type> peekN(std::size_t) throw(ParseError) override;
+
+        // Consuming the next n values.
+        virtual void advance(std::size_t) throw(ParseError) override;
+
+        // Consuming and returning a value, without checking for the end of
+        // the stream.
+        virtual value_type getUnchecked() override;
+
+        // Moving to an absolute position within the range.
+        virtual void seek(std::size_t) throw(ParseError) override;
+
+        // Making an IteratorParser at the same position over the same range.
+        // The range isn't copied, so it has to outlive every fork.
+        virtual std::unique_ptr<ParseStream<value_type>> fork() const override;
+    };
+
+    // Constructing an IteratorParser while letting the compiler figure out the
+    // iterator type.
+    template <typename It>
+    IteratorParser<It> makeIteratorParser(It, It);
+}
+
+#include "iteratorparser.tpp"
+
+#endif
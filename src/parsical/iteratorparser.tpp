@@ -0,0 +1,349 @@
+#include "iteratorparser.hpp"
+
+////
+// IteratorParser
+
+// Constructing an IteratorParser from the range [begin, end).
+template <typename It, typename Category>
+parsical::IteratorParser<It, Category>::IteratorParser(It begin, It end) :
+        base(0),
+        cur(begin),
+        end(end),
+        p(0) { }
+
+// Checking whether this ParseStream has reached its end.
+template <typename It, typename Category>
+bool parsical::IteratorParser<It, Category>::eof() const noexcept {
+    return p >= base + replay.size() && cur == end;
+}
+
+// Peeking at the next value without consuming it.
+template <typename It, typename Category>
+typename parsical::IteratorParser<It, Category>::value_type parsical::IteratorParser<It, Category>::peek() const throw(parsical::ParseError) {
+    if (eof())
+        throw parsical::ParseError(parsical::ErrorCode::EndOfInput, "Cannot peek after EOF has been reached.", pos());
+    if (p < base + replay.size())
+        return replay[p - base];
+    return *cur;
+}
+
+// Getting the current position in this ParseStream.
+template <typename It, typename Category>
+std::size_t parsical::IteratorParser<It, Category>::pos() const noexcept { return p; }
+
+// Consuming and returning a value.
+template <typename It, typename Category>
+typename parsical::IteratorParser<It, Category>::value_type parsical::IteratorParser<It, Category>::get() throw(parsical::ParseError) {
+    if (eof())
+        throw parsical::ParseError(parsical::ErrorCode::EndOfInput, "Cannot get after EOF has been reached.", pos());
+    if (p < base + replay.size())
+        return replay[p++ - base];
+
+    replay.push_back(*cur);
+    ++cur;
+    p++;
+
+    return replay.back();
+}
+
+// Stepping back some interval.
+template <typename It, typename Category>
+void parsical::IteratorParser<It, Category>::stepBack(std::size_t n) throw(parsical::ParseError) {
+    if (n > pos())
+        throw parsical::ParseError(parsical::ErrorCode::BadStepBack, "Stepping back so far would make the current position negative.", pos());
+    if (p - n < base)
+        throw parsical::ParseError(parsical::ErrorCode::BadStepBack, "Cannot step back into input that has been discarded.", pos());
+    p -= n;
+}
+
+// Dropping the replayed values before the given position.
+template <typename It, typename Category>
+void parsical::IteratorParser<It, Category>::discardBefore(std::size_t position) noexcept {
+    position = std::min(position, p);
+    while (base < position) {
+        replay.pop_front();
+        base++;
+    }
+}
+
+////
+// IteratorParser (forward)
+
+template <typename It>
+constexpr std::size_t parsical::IteratorParser<It, std::forward_iterator_tag>::checkpointInterval;
+
+// Constructing an IteratorParser from the range [begin, end).
+template <typename It>
+parsical::IteratorParser<It, std::forward_iterator_tag>::IteratorParser(It begin, It end) :
+        firstCheckpoint(0),
+        discarded(0),
+        cur(begin),
+        end(end),
+        p(0) { }
+
+// Checking whether this ParseStream has reached its end.
+template <typename It>
+bool parsical::IteratorParser<It, std::forward_iterator_tag>::eof() const noexcept {
+    return cur == end;
+}
+
+// Peeking at the next value without consuming it.
+template <typename It>
+typename parsical::IteratorParser<It, std::forward_iterator_tag>::value_type parsical::IteratorParser<It, std::forward_iterator_tag>::peek() const throw(parsical::ParseError) {
+    if (eof())
+        throw parsical::ParseError(parsical::ErrorCode::EndOfInput, "Cannot peek after EOF has been reached.", pos());
+    return *cur;
+}
+
+// Getting the current position in this ParseStream.
+template <typename It>
+std::size_t parsical::IteratorParser<It, std::forward_iterator_tag>::pos() const noexcept { return p; }
+
+// Consuming and returning a value.
+template <typename It>
+typename parsical::IteratorParser<It, std::forward_iterator_tag>::value_type parsical::IteratorParser<It, std::forward_iterator_tag>::get() throw(parsical::ParseError) {
+    if (eof())
+        throw parsical::ParseError(parsical::ErrorCode::EndOfInput, "Cannot get after EOF has been reached.", pos());
+
+    // Positions are only ever reached in order the first time around, so a
+    // checkpoint is due exactly when this one is next in line.
+    if (p % checkpointInterval == 0 && p / checkpointInterval == firstCheckpoint + checkpoints.size())
+        checkpoints.push_back(cur);
+
+    value_type value = *cur;
+    ++cur;
+    p++;
+
+    return value;
+}
+
+// Stepping back some interval.
+template <typename It>
+void parsical::IteratorParser<It, std::forward_iterator_tag>::stepBack(std::size_t n) throw(parsical::ParseError) {
+    if (n > pos())
+        throw parsical::ParseError(parsical::ErrorCode::BadStepBack, "Stepping back so far would make the current position negative.", pos());
+
+    std::size_t target = p - n;
+    std::size_t checkpoint = target / checkpointInterval;
+    if (target < discarded)
+        throw parsical::ParseError(parsical::ErrorCode::BadStepBack, "Cannot step back into input that has been discarded.", pos());
+
+    cur = checkpoints[checkpoint - firstCheckpoint];
+    std::advance(cur, target - checkpoint * checkpointInterval);
+    p = target;
+}
+
+// Dropping the saved iterators before the given position.
+template <typename It>
+void parsical::IteratorParser<It, std::forward_iterator_tag>::discardBefore(std::size_t position) noexcept {
+    discarded = std::max(discarded, std::min(position, p));
+
+    std::size_t keep = discarded / checkpointInterval;
+    while (firstCheckpoint < keep && !checkpoints.empty()) {
+        checkpoints.pop_front();
+        firstCheckpoint++;
+    }
+}
+
+// Making an IteratorParser at the same position over the same range.
+// The range isn't copied, so it has to outlive every fork.
+template <typename It>
+std::unique_ptr<parsical::ParseStream<typename parsical::IteratorParser<It, std::forward_iterator_tag>::value_type>> parsical::IteratorParser<It, std::forward_iterator_tag>::fork() const {
+    return std::unique_ptr<parsical::ParseStream<value_type>>(new parsical::IteratorParser<It, std::forward_iterator_tag>(*this));
+}
+
+////
+// IteratorParser (bidirectional)
+
+// Constructing an IteratorParser from the range [begin, end).
+template <typename It>
+parsical::IteratorParser<It, std::bidirectional_iterator_tag>::IteratorParser(It begin, It end) :
+        cur(begin),
+        end(end),
+        p(0) { }
+
+// Checking whether this ParseStream has reached its end.
+template <typename It>
+bool parsical::IteratorParser<It, std::bidirectional_iterator_tag>::eof() const noexcept {
+    return cur == end;
+}
+
+// Peeking at the next value without consuming it.
+template <typename It>
+typename parsical::IteratorParser<It, std::bidirectional_iterator_tag>::value_type parsical::IteratorParser<It, std::bidirectional_iterator_tag>::peek() const throw(parsical::ParseError) {
+    if (eof())
+        throw parsical::ParseError(parsical::ErrorCode::EndOfInput, "Cannot peek after EOF has been reached.", pos());
+    return *cur;
+}
+
+// Getting the current position in this ParseStream.
+template <typename It>
+std::size_t parsical::IteratorParser<It, std::bidirectional_iterator_tag>::pos() const noexcept { return p; }
+
+// Consuming and returning a value.
+template <typename It>
+typename parsical::IteratorParser<It, std::bidirectional_iterator_tag>::value_type parsical::IteratorParser<It, std::bidirectional_iterator_tag>::get() throw(parsical::ParseError) {
+    if (eof())
+        throw parsical::ParseError(parsical::ErrorCode::EndOfInput, "Cannot get after EOF has been reached.", pos());
+    p++;
+    return *cur++;
+}
+
+// Stepping back some interval.
+template <typename It>
+void parsical::IteratorParser<It, std::bidirectional_iterator_tag>::stepBack(std::size_t n) throw(parsical::ParseError) {
+    if (n > pos())
+        throw parsical::ParseError(parsical::ErrorCode::BadStepBack, "Stepping back so far would make the current position negative.", pos());
+    std::advance(cur, -static_cast<std::ptrdiff_t>(n));
+    p -= n;
+}
+
+// Whether any earlier position can be stepped back to.
+template <typename It>
+bool parsical::IteratorParser<It, std::bidirectional_iterator_tag>::rewindable() const noexcept { return true; }
+
+// Making an IteratorParser at the same position over the same range.
+// The range isn't copied, so it has to outlive every fork.
+template <typename It>
+std::unique_ptr<parsical::ParseStream<typename parsical::IteratorParser<It, std::bidirectional_iterator_tag>::value_type>> parsical::IteratorParser<It, std::bidirectional_iterator_tag>::fork() const {
+    return std::unique_ptr<parsical::ParseStream<value_type>>(new parsical::IteratorParser<It, std::bidirectional_iterator_tag>(*this));
+}
+
+////
+// IteratorParser (random access)
+
+// Constructing an IteratorParser from the range [begin, end). The
+// optional base is added to every position reported, for when the
+// range is a piece of some larger input.
+template <typename It>
+parsical::IteratorParser<It, std::random_access_iterator_tag>::IteratorParser(It begin, It end, std::size_t base) :
+        begin(begin),
+        cur(begin),
+        end(end),
+        base(base) { }
+
+// Pointing this IteratorParser at a new range, so that it can be
+// reused without being reconstructed.
+template <typename It>
+void parsical::IteratorParser<It, std::random_access_iterator_tag>::reset(It begin, It end, std::size_t base) noexcept {
+    this->begin = begin;
+    this->cur = begin;
+    this->end = end;
+    this->base = base;
+    this->resetCut();
+}
+
+// Checking whether this ParseStream has reached its end.
+template <typename It>
+bool parsical::IteratorParser<It, std::random_access_iterator_tag>::eof() const noexcept {
+    return cur >= end;
+}
+
+// Peeking at the next value without consuming it.
+template <typename It>
+typename parsical::IteratorParser<It, std::random_access_iterator_tag>::value_type parsical::IteratorParser<It, std::random_access_iterator_tag>::peek() const throw(parsical::ParseError) {
+    if (eof())
+        throw parsical::ParseError(parsical::ErrorCode::EndOfInput, "Cannot peek after EOF has been reached.", pos());
+    return *cur;
+}
+
+// Getting the current position in this ParseStream.
+template <typename It>
+std::size_t parsical::IteratorParser<It, std::random_access_iterator_tag>::pos() const noexcept {
+    return base + static_cast<std::size_t>(cur - begin);
+}
+
+// Consuming and returning a value.
+template <typename It>
+typename parsical::IteratorParser<It, std::random_access_iterator_tag>::value_type parsical::IteratorParser<It, std::random_access_iterator_tag>::get() throw(parsical::ParseError) {
+    if (eof())
+        throw parsical::ParseError(parsical::ErrorCode::EndOfInput, "Cannot get after EOF has been reached.", pos());
+    return *cur++;
+}
+
+// Stepping back some interval.
+template <typename It>
+void parsical::IteratorParser<It, std::random_access_iterator_tag>::stepBack(std::size_t n) throw(parsical::ParseError) {
+    if (n > static_cast<std::size_t>(cur - begin))
+        throw parsical::ParseError(parsical::ErrorCode::BadStepBack, "Stepping back so far would move before the start of the range.", pos());
+    cur -= n;
+}
+
+// Looking at the next n values. Pointers can hand out a view
+// directly; other iterators are copied into scratch.
+template <typename It>
+parsical::Span<typename parsical::IteratorParser<It, std::random_access_iterator_tag>::value_type> parsical::IteratorParser<It, std::random_access_iterator_tag>::peekNFrom(std::size_t n, std::true_type) throw(parsical::ParseError) {
+    if (!ensure(n))
+        throw parsical::ParseError(parsical::ErrorCode::EndOfInput, "Cannot peek past EOF.", pos());
+    return parsical::Span<value_type>(cur, n);
+}
+
+template <typename It>
+parsical::Span<typename parsical::IteratorParser<It, std::random_access_iterator_tag>::value_type> parsical::IteratorParser<It, std::random_access_iterator_tag>::peekNFrom(std::size_t n, std::false_type) throw(parsical::ParseError) {
+    if (!ensure(n))
+        throw parsical::ParseError(parsical::ErrorCode::EndOfInput, "Cannot peek past EOF.", pos());
+
+    scratch.assign(cur, cur + n);
+    return parsical::Span<value_type>(scratch.data(), n);
+}
+
+// Whether ensure, peekN and advance work on a buffer.
+template <typename It>
+bool parsical::IteratorParser<It, std::random_access_iterator_tag>::buffered() const noexcept { return true; }
+
+// Whether any earlier position can be stepped back to.
+template <typename It>
+bool parsical::IteratorParser<It, std::random_access_iterator_tag>::rewindable() const noexcept { return true; }
+
+// Checking that at least n more values are available.
+template <typename It>
+bool parsical::IteratorParser<It, std::random_access_iterator_tag>::ensure(std::size_t n) {
+    return static_cast<std::size_t>(end - cur) >= n;
+}
+
+// Looking at the next n values without consuming them.
+template <typename It>
+parsical::Span<typename parsical::IteratorParser<It, std::random_access_iterator_tag>::value_type> parsical::IteratorParser<It, std::random_access_iterator_tag>::peekN(std::size_t n) throw(parsical::ParseError) {
+    return peekNFrom(n, std::is_pointer<It>());
+}
+
+// Consuming the next n values.
+template <typename It>
+void parsical::IteratorParser<It, std::random_access_iterator_tag>::advance(std::size_t n) throw(parsical::ParseError) {
+    if (!ensure(n))
+        throw parsical::ParseError(parsical::ErrorCode::EndOfInput, "Cannot advance past EOF.", pos());
+    cur += n;
+}
+
+// Consuming and returning a value, without checking for the end of
+// the stream.
+template <typename It>
+typename parsical::IteratorParser<It, std::random_access_iterator_tag>::value_type parsical::IteratorParser<It, std::random_access_iterator_tag>::getUnchecked() {
+    return *cur++;
+}
+
+// Moving to an absolute position within the range.
+template <typename It>
+void parsical::IteratorParser<It, std::random_access_iterator_tag>::seek(std::size_t position) throw(parsical::ParseError) {
+    if (position < base || position - base > static_cast<std::size_t>(end - begin))
+        throw parsical::ParseError(parsical::ErrorCode::BadSeek, "Cannot seek outside of the range.", pos());
+    cur = begin + (position - base);
+    this->resetCut();
+}
+
+// Making an IteratorParser at the same position over the same range.
+// The range isn't copied, so it has to outlive every fork.
+template <typename It>
+std::unique_ptr<parsical::ParseStream<typename parsical::IteratorParser<It, std::random_access_iterator_tag>::value_type>> parsical::IteratorParser<It, std::random_access_iterator_tag>::fork() const {
+    return std::unique_ptr<parsical::ParseStream<value_type>>(new parsical::IteratorParser<It, std::random_access_iterator_tag>(*this));
+}
+
+////
+// makeIteratorParser
+
+// Constructing an IteratorParser while letting the compiler figure out the
+// iterator type.
+template <typename It>
+parsical::IteratorParser<It> parsical::makeIteratorParser(It begin, It end) {
+    return parsical::IteratorParser<It>(begin, end);
+}
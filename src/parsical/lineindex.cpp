@@ -0,0 +1,72 @@
+#include "lineindex.hpp"
+
+//////////////
+// Includes //
+#include <algorithm>
+#include <cstring>
+
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+//////////
+// Code //
+
+// Recording the start of every line up to the given offset.
+void parsical::LineIndex::scanTo(std::size_t offset) {
+    // Scanning in large steps past what was asked for, so that a run of
+    // lookups moving forward through the input doesn't rescan piecemeal.
+    std::size_t target = std::min(size, std::max(offset, scanned + (1 << 16)));
+    std::size_t i = scanned;
+
+#ifdef __SSE2__
+    // Comparing 16 bytes at a time, and only looking at single bytes when
+    // the block has a newline in it.
+    const __m128i newline = _mm_set1_epi8('\n');
+    for (; i + 16 <= target; i += 16) {
+        __m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i));
+        unsigned mask = static_cast<unsigned>(_mm_movemask_epi8(_mm_cmpeq_epi8(block, newline)));
+        while (mask != 0) {
+            starts.push_back(i + __builtin_ctz(mask) + 1);
+            mask &= mask - 1;
+        }
+    }
+#endif
+
+    while (i < target) {
+        const void* found = std::memchr(data + i, '\n', target - i);
+        if (found == nullptr) {
+            i = target;
+            break;
+        }
+
+        i = static_cast<const char*>(found) - data + 1;
+        starts.push_back(i);
+    }
+
+    scanned = target;
+}
+
+// Creating an index over size bytes starting at data.
+parsical::LineIndex::LineIndex(const char* data, std::size_t size) :
+        data(data),
+        size(size),
+        scanned(0),
+        starts(1, 0) { }
+
+// Finding the line and column of an offset. Offsets past the end are
+// treated as the end.
+parsical::LineCol parsical::LineIndex::lineCol(std::size_t offset) {
+    offset = std::min(offset, size);
+
+    std::lock_guard<std::mutex> guard(lock);
+    if (offset > scanned)
+        scanTo(offset);
+
+    // A newline at the offset itself belongs to the line it ends, so only
+    // line starts at or before the offset count.
+    std::vector<std::size_t>::const_iterator it = std::upper_bound(starts.begin(), starts.end(), offset);
+    std::size_t line = it - starts.begin();
+
+    return LineCol { line, offset - starts[line - 1] + 1 };
+}
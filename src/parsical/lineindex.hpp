@@ -0,0 +1,57 @@
+// Name: parsical/lineindex.hpp
+//
+// Description:
+//   Turning offsets into contiguous input into lines and columns, for error
+//   messages, without rescanning the input every time.
+
+#ifndef _PARSICAL_LINE_INDEX_HPP_
+#define _PARSICAL_LINE_INDEX_HPP_
+
+//////////////
+// Includes //
+#include <cstddef>
+#include <mutex>
+#include <vector>
+
+//////////
+// Code //
+
+namespace parsical {
+    // A 1-based line and column. Columns count bytes.
+    struct LineCol {
+        std::size_t line;
+        std::size_t column;
+    };
+
+    // The offsets at which each line of some contiguous input starts. Nothing
+    // is scanned until lineCol is first called, and then only as far as the
+    // offset asked about, so an index that's never used costs nothing. Lookups
+    // are a binary search over the line starts found so far.
+    //
+    // The input has to stay alive and unchanged for as long as the index
+    // does. lineCol can be called from several threads at once.
+    class LineIndex {
+    private:
+        const char* data;
+        std::size_t size;
+        std::size_t scanned;
+        std::vector<std::size_t> starts;
+        std::mutex lock;
+
+        // Recording the start of every line up to the given offset.
+        void scanTo(std::size_t);
+
+    public:
+        // Creating an index over size bytes starting at data.
+        LineIndex(const char*, std::size_t);
+
+        LineIndex(const LineIndex&) = delete;
+        LineIndex& operator=(const LineIndex&) = delete;
+
+        // Finding the line and column of an offset. Offsets past the end are
+        // treated as the end.
+        LineCol lineCol(std::size_t);
+    };
+}
+
+#endif
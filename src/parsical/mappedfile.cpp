@@ -0,0 +1,57 @@
+#include "mappedfile.hpp"
+
+//////////////
+// Includes //
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+//////////
+// Code //
+
+// Mapping the file at the given path.
+parsical::MappedFile::MappedFile(std::string path) throw(std::runtime_error) :
+        ptr(nullptr),
+        length(0) {
+    int fd = open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0)
+        throw std::runtime_error("Could not open file: " + path);
+
+    struct stat st;
+    if (fstat(fd, &st) < 0) {
+        close(fd);
+        throw std::runtime_error("Could not stat file: " + path);
+    }
+
+    length = st.st_size;
+    if (length > 0) {
+        void* mapped = mmap(nullptr, length, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (mapped == MAP_FAILED) {
+            close(fd);
+            throw std::runtime_error("Could not map file: " + path);
+        }
+        ptr = static_cast<const char*>(mapped);
+    }
+
+    close(fd);
+    lines.reset(new parsical::LineIndex(ptr, length));
+}
+
+// Unmapping the file.
+parsical::MappedFile::~MappedFile() {
+    if (ptr != nullptr)
+        munmap(const_cast<char*>(ptr), length);
+}
+
+// The start of the mapping.
+const char* parsical::MappedFile::data() const noexcept { return ptr; }
+
+// The size of the file.
+std::size_t parsical::MappedFile::size() const noexcept { return length; }
+
+// Finding the line and column of an offset into the file. Nothing is
+// scanned until this is first called.
+parsical::LineCol parsical::MappedFile::lineCol(std::size_t offset) const {
+    return lines->lineCol(offset);
+}
@@ -0,0 +1,51 @@
+// Name: parsical/mappedfile.hpp
+//
+// Description:
+//   A read-only memory mapping of a file, for parsing large inputs in place.
+
+#ifndef _PARSICAL_MAPPED_FILE_HPP_
+#define _PARSICAL_MAPPED_FILE_HPP_
+
+//////////////
+// Includes //
+#include <cstddef>
+#include <memory>
+#include <stdexcept>
+#include <string>
+
+#include "lineindex.hpp"
+
+//////////
+// Code //
+
+namespace parsical {
+    // A file mapped into memory for as long as the MappedFile is alive.
+    class MappedFile {
+    private:
+        const char* ptr;
+        std::size_t length;
+        std::unique_ptr<LineIndex> lines;
+
+    public:
+        // Mapping the file at the given path.
+        MappedFile(std::string) throw(std::runtime_error);
+
+        // Unmapping the file.
+        ~MappedFile();
+
+        MappedFile(const MappedFile&) = delete;
+        MappedFile& operator=(const MappedFile&) = delete;
+
+        // The start of the mapping.
+        const char* data() const noexcept;
+
+        // The size of the file.
+        std::size_t size() const noexcept;
+
+        // Finding the line and column of an offset into the file. Nothing is
+        // scanned until this is first called.
+        LineCol lineCol(std::size_t) const;
+    };
+}
+
+#endif
@@ -0,0 +1,37 @@
+#include "parallel.hpp"
+
+//////////////
+// Includes //
+#include <cstring>
+
+//////////
+// Code //
+
+// Splitting size bytes of data into at most the given number of chunks of
+// roughly equal size, such that every chunk but the last ends just after
+// a delimiter. Returns the offset each chunk starts at, plus size at the
+// end.
+std::vector<std::size_t> parsical::splitRecords(const char* data, std::size_t size, char delimiter, std::size_t chunks) {
+    std::vector<std::size_t> bounds { 0 };
+    if (chunks == 0)
+        chunks = 1;
+
+    for (std::size_t i = 1; i < chunks; i++) {
+        std::size_t target = size / chunks * i;
+        if (target < bounds.back())
+            continue;
+
+        const void* found = std::memchr(data + target, delimiter, size - target);
+        if (found == nullptr)
+            break;
+
+        std::size_t at = static_cast<const char*>(found) - data + 1;
+        if (at >= size)
+            break;
+        if (at > bounds.back())
+            bounds.push_back(at);
+    }
+
+    bounds.push_back(size);
+    return bounds;
+}
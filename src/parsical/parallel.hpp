@@ -0,0 +1,99 @@
+// Name: parsical/parallel.hpp
+//
+// Description:
+//   Functions for parsing large, record-delimited inputs across many threads.
+
+#ifndef _PARSICAL_PARALLEL_HPP_
+#define _PARSICAL_PARALLEL_HPP_
+
+//////////////
+// Includes //
+#include <cstddef>
+#include <string>
+#include <vector>
+
+#include "parsestream.hpp"
+#include "parseerror.hpp"
+#include "iteratorparser.hpp"
+#include "mappedfile.hpp"
+#include "executor.hpp"
+
+//////////
+// Code //
+
+namespace parsical {
+    // Splitting size bytes of data into at most the given number of chunks of
+    // roughly equal size, such that every chunk but the last ends just after
+    // a delimiter. Returns the offset each chunk starts at, plus size at the
+    // end.
+    std::vector<std::size_t> splitRecords(const char*, std::size_t, char, std::size_t);
+
+    // The parallel version of many for delimited records. The input is split
+    // with splitRecords, and each chunk is parsed by calling the function
+    // until the chunk is used up, on a worker of the Executor with a stream
+    // of its own. The records come back in input order. The function is
+    // called from many threads at once.
+    //
+    // Unlike many, a record that fails to parse is an error. The ParseError
+    // of the earliest failing chunk is rethrown, with its absolute position
+    // in the input. If chunks is 0, the input is split into a few chunks per
+    // worker so that stealing can even out the load.
+    template <typename ReturnType,
+              typename FunctionType>
+    std::vector<ReturnType> parallelMany(const char*, std::size_t, char, FunctionType, Executor&, std::size_t chunks = 0) throw(ParseError);
+
+    template <typename ReturnType,
+              typename FunctionType>
+    std::vector<ReturnType> parallelMany(const std::string&, char, FunctionType, Executor&, std::size_t chunks = 0) throw(ParseError);
+
+    template <typename ReturnType,
+              typename FunctionType>
+    std::vector<ReturnType> parallelMany(const MappedFile&, char, FunctionType, Executor&, std::size_t chunks = 0) throw(ParseError);
+
+    // The records parsed out of a single chunk of a speculativeMany, under a
+    // single hypothesis.
+    template <typename ReturnType>
+    struct Speculation {
+        std::vector<ReturnType> values;
+        std::size_t start;
+        std::size_t end;
+        bool failed;
+        ParseError error;
+
+        // Parsing records with fn for as long as they start before the given
+        // limit.
+        template <typename FunctionType>
+        void run(ParseStream<char>&, std::size_t, FunctionType&);
+    };
+
+    // A version of parallelMany for formats where the delimiter can also show
+    // up inside of a record - like newlines in quoted CSV fields, or inside
+    // of comment blocks - so a chunk can't be assumed to start on a record.
+    //
+    // Every chunk after the first is parsed once per hypothesized state the
+    // input could be in at the chunk's start. The sync function is called
+    // with a stream positioned right after the delimiter the chunk starts
+    // on, and a hypothesis, and has to skip to where the next record would
+    // start if the hypothesis were true. Records are then parsed as long as
+    // they start inside of the chunk.
+    //
+    // The chunks are stitched together in order afterwards: the hypothesis
+    // that's picked for a chunk is the one whose first record starts exactly
+    // where the previous chunk's last record ended. If none of them do, the
+    // chunk is re-parsed from there on the calling thread.
+    template <typename ReturnType,
+              typename State,
+              typename SyncType,
+              typename FunctionType>
+    std::vector<ReturnType> speculativeMany(const char*, std::size_t, char, const std::vector<State>&, SyncType, FunctionType, Executor&, std::size_t chunks = 0) throw(ParseError);
+
+    template <typename ReturnType,
+              typename State,
+              typename SyncType,
+              typename FunctionType>
+    std::vector<ReturnType> speculativeMany(const std::string&, char, const std::vector<State>&, SyncType, FunctionType, Executor&, std::size_t chunks = 0) throw(ParseError);
+}
+
+#include "parallel.tpp"
+
+#endif
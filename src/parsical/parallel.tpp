@@ -0,0 +1,201 @@
+#include "parallel.hpp"
+
+//////////////
+// Includes //
+#include <exception>
+#include <iterator>
+#include <string>
+
+//////////
+// Code //
+
+// The parallel version of many for delimited records. The input is split
+// with splitRecords, and each chunk is parsed by calling the function
+// until the chunk is used up, on a worker of the Executor with a stream
+// of its own. The records come back in input order.
+template <typename ReturnType,
+          typename FunctionType>
+std::vector<ReturnType> parsical::parallelMany(const char* data, std::size_t size, char delimiter, FunctionType fn, parsical::Executor& executor, std::size_t chunks) throw(parsical::ParseError) {
+    if (chunks == 0)
+        chunks = executor.size() * 4;
+
+    std::vector<std::size_t> bounds = parsical::splitRecords(data, size, delimiter, chunks);
+    std::size_t count = bounds.size() - 1;
+
+    std::vector<std::vector<ReturnType>> results(count);
+    std::vector<parsical::ParseError> errors(count);
+    std::vector<char> failed(count, false);
+
+    executor.run(count, [&](std::size_t, std::size_t i) {
+        parsical::IteratorParser<const char*> stream(data + bounds[i], data + bounds[i + 1], bounds[i]);
+
+        try {
+            while (!stream.eof()) {
+                std::size_t start = stream.pos();
+                results[i].push_back(fn(stream));
+
+                if (stream.pos() == start)
+                    throw parsical::ParseError(parsical::ErrorCode::NoProgress, "parallelMany: record parser consumed no input.", stream.pos());
+            }
+        } catch (parsical::ParseError& e) {
+            failed[i] = true;
+            errors[i] = e;
+            errors[i].locate(stream.pos());
+        }
+    });
+
+    std::size_t total = 0;
+    for (std::size_t i = 0; i < count; i++) {
+        if (failed[i])
+            throw errors[i];
+        total += results[i].size();
+    }
+
+    std::vector<ReturnType> values;
+    values.reserve(total);
+    for (std::vector<ReturnType>& chunk: results)
+        values.insert(values.end(), std::make_move_iterator(chunk.begin()), std::make_move_iterator(chunk.end()));
+
+    return values;
+}
+
+template <typename ReturnType,
+          typename FunctionType>
+std::vector<ReturnType> parsical::parallelMany(const std::string& str, char delimiter, FunctionType fn, parsical::Executor& executor, std::size_t chunks) throw(parsical::ParseError) {
+    return parsical::parallelMany<ReturnType>(str.data(), str.size(), delimiter, fn, executor, chunks);
+}
+
+template <typename ReturnType,
+          typename FunctionType>
+std::vector<ReturnType> parsical::parallelMany(const parsical::MappedFile& file, char delimiter, FunctionType fn, parsical::Executor& executor, std::size_t chunks) throw(parsical::ParseError) {
+    return parsical::parallelMany<ReturnType>(file.data(), file.size(), delimiter, fn, executor, chunks);
+}
+
+// Parsing records with fn for as long as they start before the given
+// limit.
+template <typename ReturnType>
+template <typename FunctionType>
+void parsical::Speculation<ReturnType>::run(parsical::ParseStream<char>& stream, std::size_t limit, FunctionType& fn) {
+    start = stream.pos();
+    failed = false;
+
+    try {
+        while (!stream.eof() && stream.pos() < limit) {
+            std::size_t at = stream.pos();
+            values.push_back(fn(stream));
+
+            if (stream.pos() == at)
+                throw parsical::ParseError(parsical::ErrorCode::NoProgress, "speculativeMany: record parser consumed no input.", stream.pos());
+        }
+    } catch (parsical::ParseError& e) {
+        failed = true;
+        error = e;
+        error.locate(stream.pos());
+    }
+
+    end = stream.pos();
+}
+
+// A version of parallelMany for formats where the delimiter can also show
+// up inside of a record - like newlines in quoted CSV fields, or inside
+// of comment blocks - so a chunk can't be assumed to start on a record.
+template <typename ReturnType,
+          typename State,
+          typename SyncType,
+          typename FunctionType>
+std::vector<ReturnType> parsical::speculativeMany(const char* data, std::size_t size, char delimiter, const std::vector<State>& hypotheses, SyncType sync, FunctionType fn, parsical::Executor& executor, std::size_t chunks) throw(parsical::ParseError) {
+    typedef parsical::Speculation<ReturnType> Speculation;
+
+    if (chunks == 0)
+        chunks = executor.size() * 4;
+
+    std::vector<std::size_t> bounds = parsical::splitRecords(data, size, delimiter, chunks);
+    std::size_t count = bounds.size() - 1;
+    std::size_t guesses = hypotheses.size();
+
+    // The first chunk is known to start on a record. Every other chunk gets
+    // one Speculation per hypothesis. Records are allowed to run on past the
+    // end of their chunk, so every stream runs to the end of the input.
+    std::vector<Speculation> first(1);
+    std::vector<Speculation> speculations((count - 1) * guesses);
+
+    executor.run(1 + speculations.size(), [&](std::size_t, std::size_t task) {
+        if (task == 0) {
+            parsical::IteratorParser<const char*> stream(data, data + size);
+            first[0].run(stream, bounds[1], fn);
+            return;
+        }
+
+        std::size_t i = 1 + (task - 1) / guesses;
+        std::size_t h = (task - 1) % guesses;
+        Speculation& speculation = speculations[task - 1];
+
+        parsical::IteratorParser<const char*> stream(data + bounds[i], data + size, bounds[i]);
+        try {
+            sync(stream, hypotheses[h]);
+        } catch (parsical::ParseError&) {
+            // A hypothesis that can't even be synced to is never picked.
+            speculation.start = speculation.end = static_cast<std::size_t>(-1);
+            speculation.failed = true;
+            return;
+        }
+
+        speculation.run(stream, bounds[i + 1], fn);
+    });
+
+    // Stitching the chunks together.
+    std::vector<Speculation*> picked { &first[0] };
+    std::vector<Speculation> reparsed;
+    reparsed.reserve(count);
+
+    for (std::size_t i = 0; i < count; i++) {
+        Speculation* chosen = nullptr;
+        std::size_t expected = picked.back()->end;
+
+        if (i == 0) {
+            chosen = &first[0];
+        } else if (expected >= bounds[i + 1]) {
+            // The last record of an earlier chunk swallowed this one whole.
+            continue;
+        } else {
+            for (std::size_t h = 0; h < guesses && chosen == nullptr; h++) {
+                Speculation& speculation = speculations[(i - 1) * guesses + h];
+                if (speculation.start == expected)
+                    chosen = &speculation;
+            }
+
+            // Every hypothesis was wrong - falling back to parsing the chunk
+            // from where the last record ended.
+            if (chosen == nullptr) {
+                parsical::IteratorParser<const char*> stream(data + expected, data + size, expected);
+                reparsed.push_back(Speculation());
+                reparsed.back().run(stream, bounds[i + 1], fn);
+                chosen = &reparsed.back();
+            }
+
+            picked.push_back(chosen);
+        }
+
+        if (chosen->failed)
+            throw chosen->error;
+    }
+
+    std::size_t total = 0;
+    for (Speculation* speculation: picked)
+        total += speculation->values.size();
+
+    std::vector<ReturnType> values;
+    values.reserve(total);
+    for (Speculation* speculation: picked)
+        values.insert(values.end(), std::make_move_iterator(speculation->values.begin()), std::make_move_iterator(speculation->values.end()));
+
+    return values;
+}
+
+template <typename ReturnType,
+          typename State,
+          typename SyncType,
+          typename FunctionType>
+std::vector<ReturnType> parsical::speculativeMany(const std::string& str, char delimiter, const std::vector<State>& hypotheses, SyncType sync, FunctionType fn, parsical::Executor& executor, std::size_t chunks) throw(parsical::ParseError) {
+    return parsical::speculativeMany<ReturnType>(str.data(), str.size(), delimiter, hypotheses, sync, fn, executor, chunks);
+}
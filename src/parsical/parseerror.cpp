@@ -1,12 +1,84 @@
 #include "parseerror.hpp"
 
+// The position of an error whose position isn't known.
+constexpr std::size_t parsical::ParseError::npos;
+
 // Creating a specific parse error.
 parsical::ParseError::ParseError(std::string str) :
-        str("Parse error: " +  str) { }
+        err(parsical::ErrorCode::Custom),
+        at(npos),
+        msg(nullptr),
+        expectedSet(0),
+        custom(str) { }
 
 // Creating a generic parse error.
 parsical::ParseError::ParseError() :
-        parsical::ParseError("Generic parse error.") { }
+        parsical::ParseError(parsical::ErrorCode::Generic, "Generic parse error.") { }
+
+// Creating a parse error without allocating. The message must outlive
+// the error - in practice it's a string literal. A position of npos
+// means it isn't known. Each bit of the expected set stands for an
+// alternative that would have been accepted; what each bit means is
+// up to the parser that threw it.
+parsical::ParseError::ParseError(parsical::ErrorCode code, const char* message, std::size_t position, std::uint64_t expected) noexcept :
+        err(code),
+        at(position),
+        msg(message),
+        expectedSet(expected) { }
+
+// Creating a parse error with a message built at runtime, but
+// otherwise as above - e.g. to describe an error in more detail
+// without losing its code, position or expected set.
+parsical::ParseError::ParseError(parsical::ErrorCode code, std::string message, std::size_t position, std::uint64_t expected) :
+        err(code),
+        at(position),
+        msg(nullptr),
+        expectedSet(expected),
+        custom(message) { }
+
+// Giving an error that was thrown without a position the position
+// it's now known to have happened at. An error that already has a
+// position keeps it.
+void parsical::ParseError::locate(std::size_t position) noexcept {
+    if (at != npos)
+        return;
+
+    at = position;
+    formatted.clear();
+}
+
+// The kind of error this is.
+parsical::ErrorCode parsical::ParseError::code() const noexcept { return err; }
+
+// The position the error happened at, or npos if it isn't known.
+std::size_t parsical::ParseError::position() const noexcept { return at; }
+
+// The message, without the position or any other decoration.
+const char* parsical::ParseError::message() const noexcept {
+    // Messages built at runtime are read out of the string every time,
+    // since the error may have been copied since it was made.
+    return msg == nullptr ? custom.c_str() : msg;
+}
+
+// The set of alternatives that would have been accepted.
+std::uint64_t parsical::ParseError::expected() const noexcept { return expectedSet; }
 
 // Getting some information out of this beast.
-const char* parsical::ParseError::what() const throw() { return str.c_str(); }
+const char* parsical::ParseError::what() const throw() {
+    if (!formatted.empty())
+        return formatted.c_str();
+
+    try {
+        formatted = "Parse error";
+        if (at != npos)
+            formatted += " at position " + std::to_string(at);
+        formatted += ": ";
+        formatted += message();
+    } catch (...) {
+        // Out of memory - the bare message is better than nothing.
+        formatted.clear();
+        return message();
+    }
+
+    return formatted.c_str();
+}
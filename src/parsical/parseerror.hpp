@@ -8,6 +8,8 @@
 
 //////////////
 // Includes //
+#include <cstddef>
+#include <cstdint>
 #include <exception>
 #include <string>
 
@@ -15,18 +17,75 @@
 // Code //
 
 namespace parsical {
+    // The broad kind of a ParseError, for telling failures apart without
+    // looking at their messages.
+    enum class ErrorCode {
+        Generic,       // Nothing more specific is known.
+        Custom,        // Made from a caller's own message.
+        EndOfInput,    // Reading past the end of the stream.
+        BadStepBack,   // Stepping back further than the stream allows.
+        BadSeek,       // Seeking somewhere the stream can't go.
+        Unexpected,    // The next input wasn't what was expected.
+        NoMatch,       // None of a set of alternatives matched.
+        NoProgress,    // A repeated parser stopped consuming input.
+        NeedMoreInput  // An incremental parser ran out of what it was fed.
+    };
+
     // A specific error for parsing such that one can match against errors
     // thrown specifically by this library and not general runtime_errors.
+    //
+    // Errors are thrown and swallowed all the time by combinators like
+    // option and many, so making one is cheap: it holds a code, a position,
+    // a pointer to a static message and an optional set of expected
+    // alternatives. The full message is only built when what() asks for it.
     class ParseError : public std::exception {
     private:
-        std::string str;
+        ErrorCode err;
+        std::size_t at;
+        const char* msg;
+        std::uint64_t expectedSet;
+        std::string custom;
+        mutable std::string formatted;
+
     public:
+        // The position of an error whose position isn't known.
+        static constexpr std::size_t npos = static_cast<std::size_t>(-1);
+
         // Creating a specific parse error.
         ParseError(std::string);
 
         // Creating a generic parse error.
         ParseError();
 
+        // Creating a parse error without allocating. The message must outlive
+        // the error - in practice it's a string literal. A position of npos
+        // means it isn't known. Each bit of the expected set stands for an
+        // alternative that would have been accepted; what each bit means is
+        // up to the parser that threw it.
+        ParseError(ErrorCode, const char*, std::size_t position = npos, std::uint64_t expected = 0) noexcept;
+
+        // Creating a parse error with a message built at runtime, but
+        // otherwise as above - e.g. to describe an error in more detail
+        // without losing its code, position or expected set.
+        ParseError(ErrorCode, std::string, std::size_t position = npos, std::uint64_t expected = 0);
+
+        // Giving an error that was thrown without a position the position
+        // it's now known to have happened at. An error that already has a
+        // position keeps it.
+        void locate(std::size_t) noexcept;
+
+        // The kind of error this is.
+        ErrorCode code() const noexcept;
+
+        // The position the error happened at, or npos if it isn't known.
+        std::size_t position() const noexcept;
+
+        // The message, without the position or any other decoration.
+        const char* message() const noexcept;
+
+        // The set of alternatives that would have been accepted.
+        std::uint64_t expected() const noexcept;
+
         // Getting some information out of this beast.
         virtual const char* what() const throw() override;
     };
@@ -1,112 +1,323 @@
 #include "parsestream.hpp"
 
+//////////////
+// Includes //
+#include <algorithm>
+
+//////////
+// Code //
+
 ////
 // StringParser
 
 // Constructing a StringParser from a given string.
 parsical::StringParser::StringParser(std::string str) :
-        str(str),
+        str(std::make_shared<const std::string>(std::move(str))),
         p(0) { }
 
+// Constructing a StringParser over a string shared with another one.
+parsical::StringParser::StringParser(std::shared_ptr<const std::string> str, std::size_t p) :
+        str(str),
+        p(p) { }
+
+// Finding the line and column of a position in the string. The line
+// index is built the first time this is called.
+parsical::LineCol parsical::StringParser::lineCol(std::size_t position) {
+    if (!lines)
+        lines = std::make_shared<parsical::LineIndex>(str->data(), str->size());
+    return lines->lineCol(position);
+}
+
 // Checking whether this ParseStream has reached its end.
 bool parsical::StringParser::eof() const noexcept {
-    return pos() >= str.size();
+    return pos() >= str->size();
 }
 
 // Peeking at the next value without consuming it.
 char parsical::StringParser::peek() const throw(parsical::ParseError) {
     if (eof())
-        throw parsical::ParseError("Cannot peek after EOF has been reached.");
-    return str.at(pos());
+        throw parsical::ParseError(parsical::ErrorCode::EndOfInput, "Cannot peek after EOF has been reached.", pos());
+    return (*str)[p];
 }
 
 // Getting the current position in this ParseStream.
-int parsical::StringParser::pos() const noexcept { return p; }
+std::size_t parsical::StringParser::pos() const noexcept { return p; }
 
 // Consuming and returning a value.
 char parsical::StringParser::get() throw(parsical::ParseError) {
     if (eof())
-        throw parsical::ParseError("Cannot get after EOF has been reached.");
-    return str.at(p++);
+        throw parsical::ParseError(parsical::ErrorCode::EndOfInput, "Cannot get after EOF has been reached.", pos());
+    return (*str)[p++];
 }
 
 // Stepping back some interval.
-void parsical::StringParser::stepBack(int n) throw(parsical::ParseError) {
+void parsical::StringParser::stepBack(std::size_t n) throw(parsical::ParseError) {
     if (n > pos())
-        throw parsical::ParseError("Stepping back so far would make the current position negative.");
+        throw parsical::ParseError(parsical::ErrorCode::BadStepBack, "Stepping back so far would make the current position negative.", pos());
     p -= n;
 }
 
+// Whether ensure, peekN and advance work on a buffer.
+bool parsical::StringParser::buffered() const noexcept { return true; }
+
+// Whether any earlier position can be stepped back to.
+bool parsical::StringParser::rewindable() const noexcept { return true; }
+
+// Checking that at least n more values are available.
+bool parsical::StringParser::ensure(std::size_t n) {
+    return str->size() - p >= n;
+}
+
+// Looking at the next n values without consuming them.
+parsical::Span<char> parsical::StringParser::peekN(std::size_t n) throw(parsical::ParseError) {
+    if (!ensure(n))
+        throw parsical::ParseError(parsical::ErrorCode::EndOfInput, "Cannot peek past EOF.", pos());
+    return parsical::Span<char>(str->data() + p, n);
+}
+
+// Consuming the next n values.
+void parsical::StringParser::advance(std::size_t n) throw(parsical::ParseError) {
+    if (!ensure(n))
+        throw parsical::ParseError(parsical::ErrorCode::EndOfInput, "Cannot advance past EOF.", pos());
+    p += n;
+}
+
+// Consuming and returning a value, without checking for the end of
+// the stream.
+char parsical::StringParser::getUnchecked() { return (*str)[p++]; }
+
+// Making a StringParser at the same position. The string itself is
+// shared, not copied, and can be read from several threads at once.
+std::unique_ptr<parsical::ParseStream<char>> parsical::StringParser::fork() const {
+    std::unique_ptr<parsical::StringParser> forked(new parsical::StringParser(str, p));
+    forked->lines = lines;
+    forked->setContext(context());
+    return std::move(forked);
+}
+
+// Moving to an absolute position in the string.
+void parsical::StringParser::seek(std::size_t position) throw(parsical::ParseError) {
+    if (position > str->size())
+        throw parsical::ParseError(parsical::ErrorCode::BadSeek, "Cannot seek past EOF.", pos());
+    p = position;
+    resetCut();
+}
+
 ////
 // IStreamParser
 
-// Creating an IStreamParser from a pointer to a std::istream.
-parsical::IStreamParser::IStreamParser(std::istream* in) throw(std::runtime_error) {
+constexpr std::size_t parsical::IStreamParser::unlimited;
+
+// Reading from the istream until the buffer reaches the given
+// position or the input ends. Returns whether it reached it.
+bool parsical::IStreamParser::Buffer::fill(std::size_t end) {
+    std::streambuf* source = in->rdbuf();
+    while (base + data.size() < end && !ended) {
+        // Taking whatever the istream already has in one go, but never
+        // asking for more than that, so that interactive input isn't held
+        // up waiting for characters nobody needs yet.
+        std::streamsize avail = source->in_avail();
+        if (avail > 0) {
+            std::size_t size = data.size();
+            data.resize(size + static_cast<std::size_t>(std::min<std::streamsize>(avail, 1 << 16)));
+            data.resize(size + static_cast<std::size_t>(source->sgetn(&data[size], data.size() - size)));
+            continue;
+        }
+
+        int c = source->sbumpc();
+        if (c == std::char_traits<char>::eof())
+            ended = true;
+        else
+            data.push_back(std::char_traits<char>::to_char_type(c));
+    }
+
+    return base + data.size() >= end;
+}
+
+// Dropping the start of the buffer, up to the given position, once
+// that's enough of it to be worth moving the rest.
+void parsical::IStreamParser::Buffer::trim(std::size_t position) noexcept {
+    std::size_t drop = position - base;
+    if (drop < 4096 || drop * 2 < data.size())
+        return;
+
+    data.erase(data.begin(), data.begin() + drop);
+    base = position;
+}
+
+// Constructing a cursor into an existing Buffer.
+parsical::IStreamParser::IStreamParser(std::shared_ptr<parsical::IStreamParser::Buffer> buffer, parsical::Pin floor, std::size_t history, std::size_t p) :
+        buffer(buffer),
+        history(history),
+        p(p),
+        floor(floor) { }
+
+// Moving the floor up to the history limit.
+void parsical::IStreamParser::forget() noexcept {
+    if (history != unlimited && p - floor.position() > history)
+        floor.move(p - history);
+}
+
+// Making sure the buffer reaches the given position, trimming off
+// whatever no cursor needs any more first.
+bool parsical::IStreamParser::reach(std::size_t end) const {
+    if (end <= buffer->base + buffer->data.size())
+        return true;
+
+    buffer->trim(floor.group()->lowest(p));
+    return buffer->fill(end);
+}
+
+// Creating an IStreamParser from a pointer to a std::istream. The
+// IStreamParser takes ownership of it.
+parsical::IStreamParser::IStreamParser(std::istream* in) throw(std::runtime_error) :
+        buffer(std::make_shared<parsical::IStreamParser::Buffer>()),
+        history(unlimited),
+        p(0),
+        floor(std::make_shared<parsical::PinSet>(), 0) {
     if (!in->good())
         throw std::runtime_error("Input stream is not good.");
 
-    fromRef = false;
-    this->in = in;
-    in->get(next);
-    p = 0;
+    buffer->owned.reset(in);
+    buffer->in = in;
+    buffer->origin = in->tellg();
+    buffer->base = 0;
+    buffer->ended = false;
 }
 
 // Creating an IStreamParser from an l-value reference istream.
 parsical::IStreamParser::IStreamParser(std::istream& in) throw(std::runtime_error) :
         parsical::IStreamParser(&in) {
-    fromRef = true;
+    buffer->owned.release();
 }
 
 // Creating an IStreamParser from a path to a file on the filesystem.
 parsical::IStreamParser::IStreamParser(std::string path) throw(std::runtime_error) :
         parsical::IStreamParser(new std::ifstream(path)) { }
 
-// Cleaning up after this parser.
-parsical::IStreamParser::~IStreamParser() {
-    if (!fromRef)
-        delete in;
+// Limiting how many consumed characters are kept for stepping back.
+// Past the limit the oldest are dropped as new ones are read, so
+// memory stays constant however long the input is. A limit of 0
+// makes the parser forward-only: nothing is kept, and any stepBack
+// fails straight away, which also means tryParse and friends can't
+// rewind after a failure that consumed input. Looking ahead with
+// ensure and peekN doesn't consume anything, so it works whatever
+// the limit.
+void parsical::IStreamParser::setHistory(std::size_t n) noexcept {
+    history = n;
+    forget();
 }
 
+// Getting the current history limit.
+std::size_t parsical::IStreamParser::getHistory() const noexcept { return history; }
+
 // Checking whether this ParseStream has reached its end.
-bool parsical::IStreamParser::eof() const noexcept { return in->eof(); }
+bool parsical::IStreamParser::eof() const noexcept { return !reach(p + 1); }
 
 // Peeking at the next value without consuming it.
 char parsical::IStreamParser::peek() const throw(parsical::ParseError) {
-    if (eof())
-        throw parsical::ParseError("Cannot peek after EOF has been reached.");
-    return next;
+    if (!reach(p + 1))
+        throw parsical::ParseError(parsical::ErrorCode::EndOfInput, "Cannot peek after EOF has been reached.", pos());
+    return buffer->data[p - buffer->base];
 }
 
 // Getting the current position in this ParseStream.
-int parsical::IStreamParser::pos() const noexcept { return p; }
+std::size_t parsical::IStreamParser::pos() const noexcept { return p; }
 
 // Consuming and returning a value.
 char parsical::IStreamParser::get() throw(parsical::ParseError) {
-    if (eof())
-        throw parsical::ParseError("Cannot peek after EOF has been reached.");
-    gotten.push(next);
-    in->get(next);
+    if (!reach(p + 1))
+        throw parsical::ParseError(parsical::ErrorCode::EndOfInput, "Cannot get after EOF has been reached.", pos());
+    char c = buffer->data[p - buffer->base];
     p++;
+    forget();
 
-    return gotten.top();
+    return c;
 }
 
 // Stepping back some interval.
-void parsical::IStreamParser::stepBack(int n) throw(parsical::ParseError) {
+void parsical::IStreamParser::stepBack(std::size_t n) throw(parsical::ParseError) {
     if (n > pos())
-        throw parsical::ParseError("Stepping back so far would make the current position negative.");
-    for (int i = 0; i < n; i++)
-        unget();
+        throw parsical::ParseError(parsical::ErrorCode::BadStepBack, "Stepping back so far would make the current position negative.", pos());
+    if (p - n < floor.position())
+        throw parsical::ParseError(parsical::ErrorCode::BadStepBack, "Cannot step back into input that has been discarded.", pos());
+    p -= n;
 }
 
-// Un-getting a single character. It ought to be equivalent to
-// stepBack(1)
-void parsical::IStreamParser::unget() throw(parsical::ParseError) {
-    if (p <= 0)
-        throw ParseError("Ungetting would make the current position negative.");
+// Dropping the characters kept for stepping back to before the given
+// position.
+void parsical::IStreamParser::discardBefore(std::size_t position) noexcept {
+    position = std::min(position, p);
+    if (position > floor.position())
+        floor.move(position);
+}
+
+// Whether ensure, peekN and advance work on a buffer.
+bool parsical::IStreamParser::buffered() const noexcept { return true; }
+
+// Checking that at least n more values are available, reading them
+// into the buffer if need be.
+bool parsical::IStreamParser::ensure(std::size_t n) { return reach(p + n); }
+
+// Looking at the next n values without consuming them.
+parsical::Span<char> parsical::IStreamParser::peekN(std::size_t n) throw(parsical::ParseError) {
+    if (!reach(p + n))
+        throw parsical::ParseError(parsical::ErrorCode::EndOfInput, "Cannot peek past EOF.", pos());
+    return parsical::Span<char>(buffer->data.data() + (p - buffer->base), n);
+}
+
+// Consuming the next n values.
+void parsical::IStreamParser::advance(std::size_t n) throw(parsical::ParseError) {
+    if (!reach(p + n))
+        throw parsical::ParseError(parsical::ErrorCode::EndOfInput, "Cannot advance past EOF.", pos());
+    p += n;
+    forget();
+}
+
+// Consuming and returning a value, without checking for the end of
+// the stream.
+char parsical::IStreamParser::getUnchecked() {
+    char c = buffer->data[p - buffer->base];
+    p++;
+    forget();
+
+    return c;
+}
+
+// Moving to an absolute position. Positions still in the buffer are
+// moved to directly; anything else seeks the underlying istream,
+// which is only possible while no forks are sharing it. Positions are
+// counted from where the istream was when the parser was made.
+void parsical::IStreamParser::seek(std::size_t position) throw(parsical::ParseError) {
+    if (position >= floor.position() && position <= buffer->base + buffer->data.size()) {
+        p = position;
+        forget();
+        resetCut();
+        return;
+    }
+
+    if (buffer->origin < 0)
+        throw parsical::ParseError(parsical::ErrorCode::BadSeek, "The underlying istream can't seek.", pos());
+    if (floor.group()->size() > 1)
+        throw parsical::ParseError(parsical::ErrorCode::BadSeek, "Cannot seek the underlying istream while forks share it.", pos());
+
+    buffer->in->clear();
+    buffer->in->seekg(buffer->origin + static_cast<std::streamoff>(position));
+    if (buffer->in->fail())
+        throw parsical::ParseError(parsical::ErrorCode::BadSeek, "Could not seek the underlying istream.", pos());
+
+    buffer->data.clear();
+    buffer->base = position;
+    buffer->ended = false;
+    p = position;
+    floor.move(position);
+    resetCut();
+}
 
-    in->putback(next);
-    next = gotten.top();
-    gotten.pop();
-    p--;
+// Making a cursor at the same position, sharing this one's buffer
+// and istream, and able to step back as far as this one can.
+std::unique_ptr<parsical::ParseStream<char>> parsical::IStreamParser::fork() const {
+    std::unique_ptr<parsical::IStreamParser> forked(new parsical::IStreamParser(buffer, floor, history, p));
+    forked->setContext(context());
+    return std::move(forked);
 }
@@ -9,24 +9,65 @@
 
 //////////////
 // Includes //
+#include <cstddef>
 #include <exception>
 #include <fstream>
+#include <memory>
 #include <string>
-#include <stack>
+#include <vector>
 
 #include "parseerror.hpp"
+#include "lineindex.hpp"
+#include "pins.hpp"
+#include "span.hpp"
 
 //////////
 // Code //
 
 namespace parsical {
+    // See context.hpp.
+    struct ParseContext;
+
     // The generic ParseStream interface.
     template <typename T>
     struct ParseStream {
+    private:
+        ParseContext* ctx = nullptr;
+        std::size_t cutAt = 0;
+        std::vector<T> lookahead;
+
+    protected:
+        // Forgetting the last cut, for streams that can be pointed at new
+        // input.
+        void resetCut() noexcept { cutAt = 0; }
+
+    public:
         // Virtual destructor to preemptively eliminate any problems with
         // inherited deconstruction.
         virtual ~ParseStream() { }
 
+        // Getting the ParseContext attached to this ParseStream, if any.
+        ParseContext* context() const noexcept { return ctx; }
+
+        // Attaching a ParseContext to this ParseStream. It isn't owned by the
+        // stream, and has to outlive the parse.
+        void setContext(ParseContext* context) noexcept { ctx = context; }
+
+        // The position of the last cut. Combinators never rewind to before it.
+        std::size_t lastCut() const noexcept { return cutAt; }
+
+        // Committing to everything parsed so far. No enclosing tryParse or
+        // attempt will rewind to before the current position, and the stream
+        // is told it may let go of the input before it.
+        void cut() noexcept {
+            cutAt = pos();
+            discardBefore(cutAt);
+        }
+
+        // Letting the stream free whatever it holds on to for positions before
+        // the given one. Streams that don't buffer their history ignore this.
+        virtual void discardBefore(std::size_t) noexcept { }
+
         // Checking whether this ParseStream has reached its end.
         virtual bool eof() const noexcept = 0;
 
@@ -34,29 +75,120 @@ namespace parsical {
         virtual T peek() const throw(ParseError) = 0;
 
         // Getting the current position in this ParseStream.
-        virtual int pos() const noexcept = 0;
+        virtual std::size_t pos() const noexcept = 0;
 
         // Consuming and returning a value.
         virtual T get() throw(ParseError) = 0;
 
         // Stepping back some interval.
-        virtual void stepBack(int) throw(ParseError) = 0;
+        virtual void stepBack(std::size_t) throw(ParseError) = 0;
 
         // Un-getting a single character. It ought to be equivalent to
         // stepBack(1)
         virtual void unget() throw(ParseError) { stepBack(1); }
+
+        // Whether ensure, peekN and advance work straight on a buffer the
+        // stream keeps, rather than being the defaults below, which read
+        // ahead with get and step back again. Callers that could go either
+        // way should only use the bulk operations when this is true - on
+        // other streams they're slower than going value by value.
+        virtual bool buffered() const noexcept { return false; }
+
+        // Whether the stream can step back to any position it has been at,
+        // however far back, as cheaply as it moved forward - i.e. it never
+        // lets go of its input. Lookahead runs in place on streams like that,
+        // rather than on a fork.
+        virtual bool rewindable() const noexcept { return false; }
+
+        // Whether the input itself has turned out to be bad - e.g. it's
+        // corrupt or has been cut short - as opposed to a parse just not
+        // matching it. Combinators that would otherwise swallow a ParseError,
+        // like many and option, rethrow it once this is true.
+        virtual bool failed() const noexcept { return false; }
+
+        // Checking that at least n more values are available. Once this has
+        // returned true, the next n values can be read with getUnchecked,
+        // peekN and advance without any further checks. The default reads
+        // ahead and steps back; streams over contiguous input override it
+        // with a comparison.
+        virtual bool ensure(std::size_t n) {
+            std::size_t got = 0;
+            try {
+                while (got < n && !eof()) {
+                    get();
+                    got++;
+                }
+            } catch (ParseError& e) { }
+
+            stepBack(got);
+            return got == n;
+        }
+
+        // Looking at the next n values without consuming them. Streams over
+        // contiguous input hand back a view straight into it; the default
+        // copies them into a buffer. Either way the Span is only valid until
+        // the stream is next used.
+        virtual Span<T> peekN(std::size_t n) throw(ParseError) {
+            lookahead.clear();
+            try {
+                while (lookahead.size() < n)
+                    lookahead.push_back(get());
+            } catch (ParseError& e) {
+                stepBack(lookahead.size());
+                throw;
+            }
+
+            stepBack(n);
+            return Span<T>(lookahead.data(), lookahead.size());
+        }
+
+        // Consuming the next n values.
+        virtual void advance(std::size_t n) throw(ParseError) {
+            for (std::size_t i = 0; i < n; i++)
+                get();
+        }
+
+        // Consuming and returning a value, without checking for the end of
+        // the stream. Only valid after ensure has said there's a value.
+        virtual T getUnchecked() { return get(); }
+
+        // Moving to an absolute position. The default steps back or reads
+        // forward to get there; streams with random access jump straight to
+        // it. Either way the last cut is forgotten, since it may be past
+        // where the stream now is.
+        virtual void seek(std::size_t position) throw(ParseError) {
+            if (position < pos())
+                stepBack(pos() - position);
+            else
+                advance(position - pos());
+            resetCut();
+        }
+
+        // Making an independent cursor at the same position over the same
+        // input, which can move without affecting this one. Streams that
+        // can't do so cheaply return null. The fork shares this stream's
+        // ParseContext; give it its own before using it on another thread.
+        virtual std::unique_ptr<ParseStream<T>> fork() const { return nullptr; }
     };
 
     // A parser specifically desinged around parsing a string.
     class StringParser : public ParseStream<char> {
     private:
-        std::string str;
-        int p;
+        std::shared_ptr<const std::string> str;
+        std::size_t p;
+        std::shared_ptr<LineIndex> lines;
+
+        // Constructing a StringParser over a string shared with another one.
+        StringParser(std::shared_ptr<const std::string>, std::size_t);
 
     public:
         // Constructing a StringParser from a given string.
         StringParser(std::string);
 
+        // Finding the line and column of a position in the string. The line
+        // index is built the first time this is called.
+        LineCol lineCol(std::size_t);
+
         // Checking whether this ParseStream has reached its end.
         virtual bool eof() const noexcept override;
 
@@ -64,26 +196,88 @@ namespace parsical {
         virtual char peek() const throw(ParseError) override;
 
         // Getting the current position in this ParseStream.
-        virtual int pos() const noexcept override;
+        virtual std::size_t pos() const noexcept override;
 
         // Consuming and returning a value.
         virtual char get() throw(ParseError) override;
 
         // Stepping back some interval.
-        virtual void stepBack(int) throw(ParseError) override;
+        virtual void stepBack(std::size_t) throw(ParseError) override;
+
+        // Whether ensure, peekN and advance work on a buffer.
+        virtual bool buffered() const noexcept override;
+
+        // Whether any earlier position can be stepped back to.
+        virtual bool rewindable() const noexcept override;
+
+        // Checking that at least n more values are available.
+        virtual bool ensure(std::size_t) override;
+
+        // Looking at the next n values without consuming them.
+        virtual Span<char> peekN(std::size_t) throw(ParseError) override;
+
+        // Consuming the next n values.
+        virtual void advance(std::size_t) throw(ParseError) override;
+
+        // Consuming and returning a value, without checking for the end of
+        // the stream.
+        virtual char getUnchecked() override;
+
+        // Moving to an absolute position in the string.
+        virtual void seek(std::size_t) throw(ParseError) override;
+
+        // Making a StringParser at the same position. The string itself is
+        // shared, not copied, and can be read from several threads at once.
+        virtual std::unique_ptr<ParseStream<char>> fork() const override;
     };
 
-    // A parser designed to work on std::istreams.
+    // A parser designed to work on std::istreams. What's read is kept in a
+    // buffer, which is shared with any forks; each fork is a cursor into it,
+    // and the buffer is only trimmed past what none of them can step back
+    // to. Forks share the istream too, so they have to be used from the
+    // same thread as the parser they were made from.
     class IStreamParser : public ParseStream<char> {
     private:
-        std::stack<char> gotten;
-        std::istream* in;
-        bool fromRef;
-        char next;
-        int p;
+        // The input shared between an IStreamParser and its forks.
+        struct Buffer {
+            std::unique_ptr<std::istream> owned;
+            std::istream* in;
+            std::streamoff origin;
+            std::vector<char> data;
+            std::size_t base;
+            bool ended;
+
+            // Reading from the istream until the buffer reaches the given
+            // position or the input ends. Returns whether it reached it.
+            bool fill(std::size_t);
+
+            // Dropping the start of the buffer, up to the given position, once
+            // that's enough of it to be worth moving the rest.
+            void trim(std::size_t) noexcept;
+        };
+
+        std::shared_ptr<Buffer> buffer;
+        std::size_t history;
+        std::size_t p;
+        Pin floor;
+
+        // Constructing a cursor into an existing Buffer.
+        IStreamParser(std::shared_ptr<Buffer>, Pin, std::size_t, std::size_t);
+
+        // Moving the floor up to the history limit.
+        void forget() noexcept;
+
+        // Making sure the buffer reaches the given position, trimming off
+        // whatever no cursor needs any more first.
+        bool reach(std::size_t) const;
 
     public:
-        // Creating an IStreamParser from a pointer to a std::istream.
+        // The history limit that keeps every character, which is the
+        // default.
+        static constexpr std::size_t unlimited = static_cast<std::size_t>(-1);
+
+        // Creating an IStreamParser from a pointer to a std::istream. The
+        // IStreamParser takes ownership of it.
         IStreamParser(std::istream*) throw(std::runtime_error);
 
         // Creating an IStreamParser from an l-value reference istream.
@@ -92,8 +286,18 @@ namespace parsical {
         // Creating an IStreamParser from a path to a file on the filesystem.
         IStreamParser(std::string) throw(std::runtime_error);
 
-        // Cleaning up after this parser.
-        ~IStreamParser();
+        // Limiting how many consumed characters are kept for stepping back.
+        // Past the limit the oldest are dropped as new ones are read, so
+        // memory stays constant however long the input is. A limit of 0
+        // makes the parser forward-only: nothing is kept, and any stepBack
+        // fails straight away, which also means tryParse and friends can't
+        // rewind after a failure that consumed input. Looking ahead with
+        // ensure and peekN doesn't consume anything, so it works whatever
+        // the limit.
+        void setHistory(std::size_t) noexcept;
+
+        // Getting the current history limit.
+        std::size_t getHistory() const noexcept;
 
         // Checking whether this ParseStream has reached its end.
         virtual bool eof() const noexcept override;
@@ -102,17 +306,44 @@ namespace parsical {
         virtual char peek() const throw(ParseError) override;
 
         // Getting the current position in this ParseStream.
-        virtual int pos() const noexcept override;
+        virtual std::size_t pos() const noexcept override;
 
         // Consuming and returning a value.
         virtual char get() throw(ParseError) override;
 
         // Stepping back some interval.
-        virtual void stepBack(int) throw(ParseError) override;
+        virtual void stepBack(std::size_t) throw(ParseError) override;
 
-        // Un-getting a single character. It ought to be equivalent to
-        // stepBack(1)
-        virtual void unget() throw(ParseError) override;
+        // Dropping the characters kept for stepping back to before the given
+        // position.
+        virtual void discardBefore(std::size_t) noexcept override;
+
+        // Whether ensure, peekN and advance work on a buffer.
+        virtual bool buffered() const noexcept override;
+
+        // Checking that at least n more values are available, reading them
+        // into the buffer if need be.
+        virtual bool ensure(std::size_t) override;
+
+        // Looking at the next n values without consuming them.
+        virtual Span<char> peekN(std::size_t) throw(ParseError) override;
+
+        // Consuming the next n values.
+        virtual void advance(std::size_t) throw(ParseError) override;
+
+        // Consuming and returning a value, without checking for the end of
+        // the stream.
+        virtual char getUnchecked() override;
+
+        // Moving to an absolute position. Positions still in the buffer are
+        // moved to directly; anything else seeks the underlying istream,
+        // which is only possible while no forks are sharing it. Positions are
+        // counted from where the istream was when the parser was made.
+        virtual void seek(std::size_t) throw(ParseError) override;
+
+        // Making a cursor at the same position, sharing this one's buffer
+        // and istream, and able to step back as far as this one can.
+        virtual std::unique_ptr<ParseStream<char>> fork() const override;
     };
 }
 
@@ -0,0 +1,56 @@
+#include "pins.hpp"
+
+//////////////
+// Includes //
+#include <algorithm>
+
+//////////
+// Code //
+
+////
+// PinSet
+
+// The lowest pinned position, or the given one if it's lower or
+// nothing is pinned.
+std::size_t parsical::PinSet::lowest(std::size_t bound) const noexcept {
+    for (std::size_t position : positions)
+        bound = std::min(bound, position);
+    return bound;
+}
+
+// The number of positions pinned.
+std::size_t parsical::PinSet::size() const noexcept { return positions.size(); }
+
+////
+// Pin
+
+// Pinning a position in a PinSet.
+parsical::Pin::Pin(std::shared_ptr<parsical::PinSet> set, std::size_t position) :
+        set(set),
+        at(set->positions.insert(set->positions.end(), position)) { }
+
+parsical::Pin::Pin(const parsical::Pin& other) :
+        parsical::Pin(other.set, *other.at) { }
+
+parsical::Pin& parsical::Pin::operator=(const parsical::Pin& other) {
+    if (this == &other)
+        return *this;
+
+    std::size_t position = *other.at;
+    set->positions.erase(at);
+    set = other.set;
+    at = set->positions.insert(set->positions.end(), position);
+    return *this;
+}
+
+// Releasing the position.
+parsical::Pin::~Pin() { set->positions.erase(at); }
+
+// The PinSet this is a part of.
+const std::shared_ptr<parsical::PinSet>& parsical::Pin::group() const noexcept { return set; }
+
+// The pinned position.
+std::size_t parsical::Pin::position() const noexcept { return *at; }
+
+// Moving the pin to a new position.
+void parsical::Pin::move(std::size_t position) noexcept { *at = position; }
@@ -0,0 +1,70 @@
+// Name: parsical/pins.hpp
+//
+// Description:
+//   Keeping track of how far back each of several cursors over one shared
+//   buffer still needs it, so that the buffer is only trimmed past what none
+//   of them can step back to.
+
+#ifndef _PARSICAL_PINS_HPP_
+#define _PARSICAL_PINS_HPP_
+
+//////////////
+// Includes //
+#include <cstddef>
+#include <list>
+#include <memory>
+
+//////////
+// Code //
+
+namespace parsical {
+    // See below.
+    class Pin;
+
+    // The positions pinned by a group of cursors sharing a buffer. Nothing
+    // at or after the lowest of them may be let go of. It isn't locked, so
+    // the cursors have to be used from one thread.
+    class PinSet {
+    private:
+        friend class Pin;
+
+        std::list<std::size_t> positions;
+
+    public:
+        // The lowest pinned position, or the given one if it's lower or
+        // nothing is pinned.
+        std::size_t lowest(std::size_t) const noexcept;
+
+        // The number of positions pinned.
+        std::size_t size() const noexcept;
+    };
+
+    // A single cursor's position in a PinSet. It's released when the Pin is
+    // destroyed, and copying a Pin pins the same position again.
+    class Pin {
+    private:
+        std::shared_ptr<PinSet> set;
+        std::list<std::size_t>::iterator at;
+
+    public:
+        // Pinning a position in a PinSet.
+        Pin(std::shared_ptr<PinSet>, std::size_t);
+
+        Pin(const Pin&);
+        Pin& operator=(const Pin&);
+
+        // Releasing the position.
+        ~Pin();
+
+        // The PinSet this is a part of.
+        const std::shared_ptr<PinSet>& group() const noexcept;
+
+        // The pinned position.
+        std::size_t position() const noexcept;
+
+        // Moving the pin to a new position.
+        void move(std::size_t) noexcept;
+    };
+}
+
+#endif
@@ -0,0 +1,195 @@
+#include "pushparser.hpp"
+
+//////////////
+// Includes //
+#include <algorithm>
+
+//////////
+// Code //
+
+////
+// NeedMoreInput
+
+// Creating a NeedMoreInput error.
+parsical::NeedMoreInput::NeedMoreInput() :
+        parsical::ParseError(parsical::ErrorCode::NeedMoreInput, "Need more input.") { }
+
+////
+// FeedParser
+
+// Constructing a cursor into an existing Feed.
+parsical::FeedParser::FeedParser(std::shared_ptr<parsical::FeedParser::Feed> input, parsical::Pin floor, std::size_t p) :
+        input(input),
+        floor(floor),
+        p(p) { }
+
+// Constructing an empty FeedParser.
+parsical::FeedParser::FeedParser() :
+        input(std::make_shared<parsical::FeedParser::Feed>()),
+        floor(std::make_shared<parsical::PinSet>(), 0),
+        p(0) {
+    input->base = 0;
+    input->finished = false;
+    input->hungry = false;
+    input->wanted = 0;
+}
+
+// Dropping the prefix of the buffer that no cursor needs, once it's
+// at least half of it - so that discarding a record at a time stays
+// linear.
+void parsical::FeedParser::compact() noexcept {
+    std::size_t lowest = floor.group()->lowest(p);
+    std::size_t drop = lowest - input->base;
+    if (drop == 0 || drop * 2 < input->buffer.size())
+        return;
+
+    input->buffer.erase(0, drop);
+    input->base = lowest;
+}
+
+// Marking the stream as starved, wanting input up to the given
+// position.
+void parsical::FeedParser::starve(std::size_t end) const noexcept {
+    input->hungry = true;
+    input->wanted = std::max(input->wanted, end);
+}
+
+// Appending more input to the end of the stream.
+void parsical::FeedParser::feed(const char* data, std::size_t size) throw(parsical::ParseError) {
+    if (input->finished)
+        throw parsical::ParseError(parsical::ErrorCode::Generic, "Cannot feed a FeedParser after finish().", pos());
+    input->buffer.append(data, size);
+}
+
+void parsical::FeedParser::feed(const std::string& data) throw(parsical::ParseError) {
+    feed(data.data(), data.size());
+}
+
+// Marking that no more input is coming. After this the end of the
+// buffered input is a real EOF.
+void parsical::FeedParser::finish() noexcept { input->finished = true; }
+
+// Checking whether finish() has been called.
+bool parsical::FeedParser::isFinished() const noexcept { return input->finished; }
+
+// Checking whether anything has tried to look past the end of the
+// input fed so far since the last call to resetStarved().
+bool parsical::FeedParser::starved() const noexcept { return input->hungry; }
+
+// Clearing the starved flag.
+void parsical::FeedParser::resetStarved() noexcept {
+    input->hungry = false;
+    input->wanted = 0;
+}
+
+// How far the input has to reach before whatever starved the stream
+// could get further - i.e. one past the furthest position a starved
+// read wanted, since the last call to resetStarved().
+std::size_t parsical::FeedParser::needed() const noexcept { return input->wanted; }
+
+// The number of values fed but not yet consumed.
+std::size_t parsical::FeedParser::available() const noexcept {
+    return input->buffer.size() - (p - input->base);
+}
+
+// Dropping all of the buffered input before the current position. It
+// is no longer possible to step back past this point.
+void parsical::FeedParser::discardConsumed() noexcept {
+    floor.move(p);
+    compact();
+}
+
+// Checking whether this ParseStream has reached its end. Before
+// finish() this is never true.
+bool parsical::FeedParser::eof() const noexcept {
+    if (available() > 0)
+        return false;
+    if (!input->finished)
+        starve(p + 1);
+    return input->finished;
+}
+
+// Peeking at the next value without consuming it.
+char parsical::FeedParser::peek() const throw(parsical::ParseError) {
+    if (available() == 0) {
+        if (input->finished)
+            throw parsical::ParseError(parsical::ErrorCode::EndOfInput, "Cannot peek after EOF has been reached.", pos());
+        starve(p + 1);
+        throw parsical::NeedMoreInput();
+    }
+
+    return input->buffer[p - input->base];
+}
+
+// Getting the current position in this ParseStream.
+std::size_t parsical::FeedParser::pos() const noexcept { return p; }
+
+// Consuming and returning a value.
+char parsical::FeedParser::get() throw(parsical::ParseError) {
+    char c = peek();
+    p++;
+    return c;
+}
+
+// Stepping back some interval.
+void parsical::FeedParser::stepBack(std::size_t n) throw(parsical::ParseError) {
+    if (n > pos())
+        throw parsical::ParseError(parsical::ErrorCode::BadStepBack, "Stepping back so far would make the current position negative.", pos());
+    if (p - n < floor.position())
+        throw parsical::ParseError(parsical::ErrorCode::BadStepBack, "Cannot step back into input that has been discarded.", pos());
+    p -= n;
+}
+
+// Dropping the buffered input before the given position, or before
+// the current position if that comes first.
+void parsical::FeedParser::discardBefore(std::size_t position) noexcept {
+    floor.move(std::max(floor.position(), std::min(position, p)));
+    compact();
+}
+
+// Whether ensure, peekN and advance work on a buffer.
+bool parsical::FeedParser::buffered() const noexcept { return true; }
+
+// Checking that at least n more values have been fed. If they haven't
+// yet, the stream is marked as starved.
+bool parsical::FeedParser::ensure(std::size_t n) {
+    if (available() >= n)
+        return true;
+    if (!input->finished)
+        starve(p + n);
+    return false;
+}
+
+// Looking at the next n values without consuming them.
+parsical::Span<char> parsical::FeedParser::peekN(std::size_t n) throw(parsical::ParseError) {
+    if (!ensure(n)) {
+        if (input->finished)
+            throw parsical::ParseError(parsical::ErrorCode::EndOfInput, "Cannot peek past EOF.", pos());
+        throw parsical::NeedMoreInput();
+    }
+
+    return parsical::Span<char>(input->buffer.data() + (p - input->base), n);
+}
+
+// Consuming the next n values.
+void parsical::FeedParser::advance(std::size_t n) throw(parsical::ParseError) {
+    if (!ensure(n)) {
+        if (input->finished)
+            throw parsical::ParseError(parsical::ErrorCode::EndOfInput, "Cannot advance past EOF.", pos());
+        throw parsical::NeedMoreInput();
+    }
+
+    p += n;
+}
+
+// Consuming and returning a value, without checking for the end of
+// the stream.
+char parsical::FeedParser::getUnchecked() { return input->buffer[p++ - input->base]; }
+
+// Making a cursor at the same position over the same input, able to
+// step back as far as this one can.
+std::unique_ptr<parsical::ParseStream<char>> parsical::FeedParser::fork() const {
+    std::unique_ptr<parsical::FeedParser> forked(new parsical::FeedParser(input, floor, p));
+    forked->setContext(context());
+    return std::move(forked);
+}
@@ -0,0 +1,201 @@
+// Name: parsical/pushparser.hpp
+//
+// Description:
+//   A feed-based ParseStream for input that arrives in partial reads (e.g.
+//   from a non-blocking socket), and a driver that suspends a parse when it
+//   runs out of input instead of failing it.
+
+#ifndef _PARSICAL_PUSH_PARSER_HPP_
+#define _PARSICAL_PUSH_PARSER_HPP_
+
+//////////////
+// Includes //
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "parsestream.hpp"
+#include "parseerror.hpp"
+#include "pins.hpp"
+
+//////////
+// Code //
+
+namespace parsical {
+    // The error thrown by a FeedParser when a parse reaches the end of the
+    // input fed so far before finish() has been called. It is a ParseError so
+    // that it can pass through the rest of the library, but combinators like
+    // many and option may well swallow it - which is why the FeedParser also
+    // remembers that it happened (see FeedParser::starved).
+    class NeedMoreInput : public ParseError {
+    public:
+        // Creating a NeedMoreInput error.
+        NeedMoreInput();
+    };
+
+    // A ParseStream over input that is handed to it piece by piece. Positions
+    // are absolute across everything that's been fed, even after the consumed
+    // prefix has been discarded.
+    //
+    // Forks share the input, including what's fed after they're made and
+    // whether it has been starved, and have to be used from the same thread
+    // as the FeedParser they were made from.
+    class FeedParser : public ParseStream<char> {
+    private:
+        // The input shared between a FeedParser and its forks.
+        struct Feed {
+            std::string buffer;
+            std::size_t base;
+            bool finished;
+            bool hungry;
+            std::size_t wanted;
+        };
+
+        std::shared_ptr<Feed> input;
+        Pin floor;
+        std::size_t p;
+
+        // Constructing a cursor into an existing Feed.
+        FeedParser(std::shared_ptr<Feed>, Pin, std::size_t);
+
+        // Dropping the prefix of the buffer that no cursor needs, once it's
+        // at least half of it - so that discarding a record at a time stays
+        // linear.
+        void compact() noexcept;
+
+        // Marking the stream as starved, wanting input up to the given
+        // position.
+        void starve(std::size_t) const noexcept;
+
+    public:
+        // Constructing an empty FeedParser.
+        FeedParser();
+
+        // Appending more input to the end of the stream.
+        void feed(const char*, std::size_t) throw(ParseError);
+        void feed(const std::string&) throw(ParseError);
+
+        // Marking that no more input is coming. After this the end of the
+        // buffered input is a real EOF.
+        void finish() noexcept;
+
+        // Checking whether finish() has been called.
+        bool isFinished() const noexcept;
+
+        // Checking whether anything has tried to look past the end of the
+        // input fed so far since the last call to resetStarved().
+        bool starved() const noexcept;
+
+        // Clearing the starved flag.
+        void resetStarved() noexcept;
+
+        // How far the input has to reach before whatever starved the stream
+        // could get further - i.e. one past the furthest position a starved
+        // read wanted, since the last call to resetStarved().
+        std::size_t needed() const noexcept;
+
+        // The number of values fed but not yet consumed.
+        std::size_t available() const noexcept;
+
+        // Dropping all of the buffered input before the current position. It
+        // is no longer possible to step back past this point.
+        void discardConsumed() noexcept;
+
+        // Checking whether this ParseStream has reached its end. Before
+        // finish() this is never true.
+        virtual bool eof() const noexcept override;
+
+        // Peeking at the next value without consuming it.
+        virtual char peek() const throw(ParseError) override;
+
+        // Getting the current position in this ParseStream.
+        virtual std::size_t pos() const noexcept override;
+
+        // Consuming and returning a value.
+        virtual char get() throw(ParseError) override;
+
+        // Stepping back some interval.
+        virtual void stepBack(std::size_t) throw(ParseError) override;
+
+        // Dropping the buffered input before the given position, or before
+        // the current position if that comes first.
+        virtual void discardBefore(std::size_t) noexcept override;
+
+        // Whether ensure, peekN and advance work on a buffer.
+        virtual bool buffered() const noexcept override;
+
+        // Checking that at least n more values have been fed. If they haven't
+        // yet, the stream is marked as starved.
+        virtual bool ensure(std::size_t) override;
+
+        // Looking at the next n values without consuming them.
+        virtual Span<char> peekN(std::size_t) throw(ParseError) override;
+
+        // Consuming the next n values.
+        virtual void advance(std::size_t) throw(ParseError) override;
+
+        // Consuming and returning a value, without checking for the end of
+        // the stream.
+        virtual char getUnchecked() override;
+
+        // Making a cursor at the same position over the same input, able to
+        // step back as far as this one can.
+        virtual std::unique_ptr<ParseStream<char>> fork() const override;
+    };
+
+    // The state a PushParser is left in after being fed.
+    enum class PushStatus {
+        // The last record is incomplete - feed more input.
+        Suspended,
+
+        // finish() was called and all of the input has been parsed.
+        Done
+    };
+
+    // Runs a record parser repeatedly over a FeedParser, in the same way that
+    // many would over a complete stream. When a record runs out of input the
+    // PushParser rewinds to where the record started and suspends. The next
+    // feed resumes from that record - input belonging to records that have
+    // already been parsed is never looked at again, and is discarded from the
+    // buffer. The record isn't retried until enough has been fed to take it
+    // past the point it starved at, so a large record arriving in small
+    // reads that it knows the length of (e.g. through ensure) is only parsed
+    // once it's all there.
+    //
+    // Unlike many, a record that fails for any reason other than running out
+    // of input is an error, and is rethrown.
+    template <typename ReturnType>
+    class PushParser {
+    private:
+        FeedParser stream;
+        std::function<ReturnType(ParseStream<char>&)> fn;
+        std::vector<ReturnType> results;
+        std::size_t resumeAt;
+
+        // Parsing as many complete records as are available.
+        PushStatus run() throw(ParseError);
+
+    public:
+        // Constructing a PushParser around a record parser.
+        PushParser(std::function<ReturnType(ParseStream<char>&)>);
+
+        // Feeding more input and parsing whatever records it completes.
+        PushStatus feed(const char*, std::size_t) throw(ParseError);
+        PushStatus feed(const std::string&) throw(ParseError);
+
+        // Marking the end of the input and parsing whatever is left.
+        PushStatus finish() throw(ParseError);
+
+        // Taking all of the records that have been parsed so far.
+        std::vector<ReturnType> take();
+
+        // Getting the underlying stream, e.g. to check its position.
+        const FeedParser& getStream() const noexcept;
+    };
+}
+
+#include "pushparser.tpp"
+
+#endif
@@ -0,0 +1,86 @@
+#include "pushparser.hpp"
+
+// Parsing as many complete records as are available.
+template <typename ReturnType>
+parsical::PushStatus parsical::PushParser<ReturnType>::run() throw(parsical::ParseError) {
+    while (true) {
+        if (stream.eof())
+            return parsical::PushStatus::Done;
+        if (stream.available() == 0)
+            return parsical::PushStatus::Suspended;
+
+        // The record that starved last time would only starve in the same
+        // place again until its input reaches as far as it wanted.
+        std::size_t start = stream.pos();
+        if (!stream.isFinished() && start + stream.available() < resumeAt)
+            return parsical::PushStatus::Suspended;
+
+        resumeAt = 0;
+        stream.resetStarved();
+
+        try {
+            ReturnType value = fn(stream);
+
+            // Whatever the record parser decided, it decided without having
+            // seen all of its input.
+            if (stream.starved()) {
+                resumeAt = stream.needed();
+                stream.stepBack(stream.pos() - start);
+                return parsical::PushStatus::Suspended;
+            }
+
+            if (stream.pos() == start)
+                throw parsical::ParseError(parsical::ErrorCode::NoProgress, "PushParser: record parser consumed no input.", stream.pos());
+
+            results.push_back(value);
+        } catch (parsical::ParseError& e) {
+            if (!stream.starved())
+                throw;
+
+            resumeAt = stream.needed();
+            stream.stepBack(stream.pos() - start);
+            return parsical::PushStatus::Suspended;
+        }
+
+        stream.discardConsumed();
+    }
+}
+
+// Constructing a PushParser around a record parser.
+template <typename ReturnType>
+parsical::PushParser<ReturnType>::PushParser(std::function<ReturnType(parsical::ParseStream<char>&)> fn) :
+        fn(fn),
+        resumeAt(0) { }
+
+// Feeding more input and parsing whatever records it completes.
+template <typename ReturnType>
+parsical::PushStatus parsical::PushParser<ReturnType>::feed(const char* data, std::size_t size) throw(parsical::ParseError) {
+    stream.feed(data, size);
+    return run();
+}
+
+template <typename ReturnType>
+parsical::PushStatus parsical::PushParser<ReturnType>::feed(const std::string& data) throw(parsical::ParseError) {
+    return feed(data.data(), data.size());
+}
+
+// Marking the end of the input and parsing whatever is left.
+template <typename ReturnType>
+parsical::PushStatus parsical::PushParser<ReturnType>::finish() throw(parsical::ParseError) {
+    stream.finish();
+    return run();
+}
+
+// Taking all of the records that have been parsed so far.
+template <typename ReturnType>
+std::vector<ReturnType> parsical::PushParser<ReturnType>::take() {
+    std::vector<ReturnType> taken;
+    taken.swap(results);
+    return taken;
+}
+
+// Getting the underlying stream, e.g. to check its position.
+template <typename ReturnType>
+const parsical::FeedParser& parsical::PushParser<ReturnType>::getStream() const noexcept {
+    return stream;
+}
@@ -0,0 +1,164 @@
+#include "readaheadparser.hpp"
+
+//////////////
+// Includes //
+#include <algorithm>
+#include <fstream>
+
+//////////
+// Code //
+
+// Checking the input and starting the helper thread.
+void parsical::ReadAheadParser::start() throw(std::runtime_error) {
+    if (!in->good())
+        throw std::runtime_error("Input stream is not good.");
+
+    reader = std::thread(&parsical::ReadAheadParser::readLoop, this);
+}
+
+// The helper thread's loop.
+void parsical::ReadAheadParser::readLoop() noexcept {
+    while (!stopping.load(std::memory_order_relaxed) && ring.waitForSpace()) {
+        char* at;
+        std::size_t n = std::min(ring.reserve(&at), blockSize);
+
+        std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+        in->read(at, n);
+        std::streamsize got = in->gcount();
+        readNanos += std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count();
+
+        if (got > 0) {
+            ring.commit(got);
+            bytes += got;
+        }
+
+        if (!in->good()) {
+            // Running out of input isn't an error; the stream going bad is.
+            if (in->bad())
+                broken.store(true, std::memory_order_release);
+            break;
+        }
+    }
+
+    ring.close();
+}
+
+// Throwing a read error, if there was one.
+void parsical::ReadAheadParser::check() const throw(parsical::ParseError) {
+    if (broken.load(std::memory_order_acquire))
+        throw parsical::ParseError(parsical::ErrorCode::Generic, "Could not read the input.", pos());
+}
+
+// Creating a ReadAheadParser from a path to a file on the filesystem.
+parsical::ReadAheadParser::ReadAheadParser(std::string path, std::size_t blockSize, std::size_t depth) throw(std::runtime_error) :
+        owned(new std::ifstream(path, std::ios::binary)),
+        in(owned.get()),
+        blockSize(blockSize),
+        ring(blockSize * std::max<std::size_t>(depth, 2)),
+        parser(ring, blockSize),
+        stopping(false),
+        broken(false),
+        readNanos(0),
+        bytes(0) {
+    start();
+}
+
+// Creating a ReadAheadParser from an l-value reference istream. The
+// istream is read from the helper thread until this is destroyed.
+parsical::ReadAheadParser::ReadAheadParser(std::istream& in, std::size_t blockSize, std::size_t depth) throw(std::runtime_error) :
+        in(&in),
+        blockSize(blockSize),
+        ring(blockSize * std::max<std::size_t>(depth, 2)),
+        parser(ring, blockSize),
+        stopping(false),
+        broken(false),
+        readNanos(0),
+        bytes(0) {
+    start();
+}
+
+// Stopping the helper thread.
+parsical::ReadAheadParser::~ReadAheadParser() {
+    stopping = true;
+    ring.abandon();
+    reader.join();
+}
+
+// Getting the I/O-wait vs. parse time so far.
+parsical::ReadAheadStats parsical::ReadAheadParser::stats() const noexcept {
+    parsical::ReadAheadStats s;
+    s.ioWaitSeconds = parser.waitSeconds();
+    s.parseSeconds = std::max(0.0, parser.activeSeconds() - s.ioWaitSeconds);
+    s.readSeconds = readNanos.load() / 1e9;
+    s.bytesRead = bytes.load();
+
+    return s;
+}
+
+// Checking whether this ParseStream has reached its end. Input that
+// stops early because of a read error hasn't: the next read throws
+// instead.
+bool parsical::ReadAheadParser::eof() const noexcept {
+    return parser.eof() && !broken.load(std::memory_order_acquire);
+}
+
+// Peeking at the next value without consuming it.
+char parsical::ReadAheadParser::peek() const throw(parsical::ParseError) {
+    if (parser.eof())
+        check();
+    return parser.peek();
+}
+
+// Getting the current position in this ParseStream.
+std::size_t parsical::ReadAheadParser::pos() const noexcept { return parser.pos(); }
+
+// Consuming and returning a value.
+char parsical::ReadAheadParser::get() throw(parsical::ParseError) {
+    if (parser.eof())
+        check();
+    return parser.get();
+}
+
+// Stepping back some interval.
+void parsical::ReadAheadParser::stepBack(std::size_t n) throw(parsical::ParseError) { parser.stepBack(n); }
+
+// Handing the space before the given position back to the reader
+// thread early.
+void parsical::ReadAheadParser::discardBefore(std::size_t position) noexcept { parser.discardBefore(position); }
+
+// Whether ensure, peekN and advance work on a buffer.
+bool parsical::ReadAheadParser::buffered() const noexcept { return true; }
+
+// Whether reading the input has failed.
+bool parsical::ReadAheadParser::failed() const noexcept { return broken.load(std::memory_order_acquire); }
+
+// Checking that at least n more values are available.
+bool parsical::ReadAheadParser::ensure(std::size_t n) { return parser.ensure(n); }
+
+// Looking at the next n values without consuming them.
+parsical::Span<char> parsical::ReadAheadParser::peekN(std::size_t n) throw(parsical::ParseError) {
+    if (!parser.ensure(n))
+        check();
+    return parser.peekN(n);
+}
+
+// Consuming the next n values.
+void parsical::ReadAheadParser::advance(std::size_t n) throw(parsical::ParseError) {
+    if (!parser.ensure(n))
+        check();
+    parser.advance(n);
+}
+
+// Consuming and returning a value, without checking for the end of
+// the stream.
+char parsical::ReadAheadParser::getUnchecked() { return parser.getUnchecked(); }
+
+// Making a cursor at the same position over the read-ahead buffer.
+// It has to be used from the same thread as this parser, and
+// destroyed before it. Read errors are only reported by the
+// ReadAheadParser itself - to a fork, the input just ends early.
+std::unique_ptr<parsical::ParseStream<char>> parsical::ReadAheadParser::fork() const {
+    std::unique_ptr<parsical::ParseStream<char>> forked = parser.fork();
+    forked->setContext(context());
+    return forked;
+}
@@ -0,0 +1,137 @@
+// Name: parsical/readaheadparser.hpp
+//
+// Description:
+//   A ParseStream over a file or std::istream where the reading is done ahead
+//   of the parser, in large blocks, on a helper thread.
+
+#ifndef _PARSICAL_READ_AHEAD_PARSER_HPP_
+#define _PARSICAL_READ_AHEAD_PARSER_HPP_
+
+//////////////
+// Includes //
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <istream>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <thread>
+
+#include "parsestream.hpp"
+#include "parseerror.hpp"
+#include "ringparser.hpp"
+
+//////////
+// Code //
+
+namespace parsical {
+    // Where the time went while parsing from a ReadAheadParser.
+    struct ReadAheadStats {
+        // Time the parser spent waiting for the reader thread.
+        double ioWaitSeconds;
+
+        // Time the parser spent doing anything else, from when it first
+        // asked for input to when it last did.
+        double parseSeconds;
+
+        // Time the reader thread spent inside of reads.
+        double readSeconds;
+
+        // The number of bytes read so far.
+        std::size_t bytesRead;
+    };
+
+    // An alternative to IStreamParser that hides I/O stalls. A helper thread
+    // fills a RingBuffer of depth blocks of blockSize bytes each, reading
+    // straight into the buffer, while the parser consumes what's already
+    // there. Stepping back is possible up to one block.
+    //
+    // A read error shows up as a ParseError at the point the good data runs
+    // out, and from then on the parser reports that it has failed, rather
+    // than the input looking like it just ended.
+    class ReadAheadParser : public ParseStream<char> {
+    private:
+        std::unique_ptr<std::istream> owned;
+        std::istream* in;
+        std::size_t blockSize;
+        RingBuffer ring;
+        RingParser parser;
+        std::atomic<bool> stopping;
+        std::atomic<bool> broken;
+        std::atomic<long long> readNanos;
+        std::atomic<std::size_t> bytes;
+        std::thread reader;
+
+        // Checking the input and starting the helper thread.
+        void start() throw(std::runtime_error);
+
+        // The helper thread's loop.
+        void readLoop() noexcept;
+
+        // Throwing a read error, if there was one.
+        void check() const throw(ParseError);
+
+    public:
+        // Creating a ReadAheadParser from a path to a file on the filesystem.
+        ReadAheadParser(std::string, std::size_t blockSize = 1 << 16, std::size_t depth = 4) throw(std::runtime_error);
+
+        // Creating a ReadAheadParser from an l-value reference istream. The
+        // istream is read from the helper thread until this is destroyed.
+        ReadAheadParser(std::istream&, std::size_t blockSize = 1 << 16, std::size_t depth = 4) throw(std::runtime_error);
+
+        // Stopping the helper thread.
+        ~ReadAheadParser();
+
+        // Getting the I/O-wait vs. parse time so far.
+        ReadAheadStats stats() const noexcept;
+
+        // Checking whether this ParseStream has reached its end. Input that
+        // stops early because of a read error hasn't: the next read throws
+        // instead.
+        virtual bool eof() const noexcept override;
+
+        // Peeking at the next value without consuming it.
+        virtual char peek() const throw(ParseError) override;
+
+        // Getting the current position in this ParseStream.
+        virtual std::size_t pos() const noexcept override;
+
+        // Consuming and returning a value.
+        virtual char get() throw(ParseError) override;
+
+        // Stepping back some interval.
+        virtual void stepBack(std::size_t) throw(ParseError) override;
+
+        // Handing the space before the given position back to the reader
+        // thread early.
+        virtual void discardBefore(std::size_t) noexcept override;
+
+        // Whether ensure, peekN and advance work on a buffer.
+        virtual bool buffered() const noexcept override;
+
+        // Whether reading the input has failed.
+        virtual bool failed() const noexcept override;
+
+        // Checking that at least n more values are available.
+        virtual bool ensure(std::size_t) override;
+
+        // Looking at the next n values without consuming them.
+        virtual Span<char> peekN(std::size_t) throw(ParseError) override;
+
+        // Consuming the next n values.
+        virtual void advance(std::size_t) throw(ParseError) override;
+
+        // Consuming and returning a value, without checking for the end of
+        // the stream.
+        virtual char getUnchecked() override;
+
+        // Making a cursor at the same position over the read-ahead buffer.
+        // It has to be used from the same thread as this parser, and
+        // destroyed before it. Read errors are only reported by the
+        // ReadAheadParser itself - to a fork, the input just ends early.
+        virtual std::unique_ptr<ParseStream<char>> fork() const override;
+    };
+}
+
+#endif
@@ -0,0 +1,98 @@
+#include "recordindex.hpp"
+
+//////////////
+// Includes //
+#include <cstring>
+#include <fstream>
+#include <utility>
+
+//////////
+// Code //
+
+// The magic number at the start of every saved index.
+static const char magic[8] = { 'P', 'R', 'S', 'C', 'I', 'D', 'X', '1' };
+
+// Creating an empty RecordIndex to build.
+parsical::RecordIndex::RecordIndex() :
+        view(nullptr),
+        count(0) { }
+
+// Loading a RecordIndex saved with save, by mapping it.
+parsical::RecordIndex::RecordIndex(std::string path) throw(std::runtime_error) :
+        mapped(new parsical::MappedFile(path)),
+        view(nullptr),
+        count(0) {
+    const std::size_t header = sizeof(magic) + sizeof(std::uint64_t);
+    if (mapped->size() < header || std::memcmp(mapped->data(), magic, sizeof(magic)) != 0)
+        throw std::runtime_error("Not a record index: " + path);
+
+    std::uint64_t stored;
+    std::memcpy(&stored, mapped->data() + sizeof(magic), sizeof(stored));
+    std::size_t body = mapped->size() - header;
+    if (body % sizeof(std::uint64_t) != 0)
+        throw std::runtime_error("Record index ends part way through an entry: " + path);
+    if (body / sizeof(std::uint64_t) != stored)
+        throw std::runtime_error("Record index is truncated: " + path);
+
+    // The header is 16 bytes and mappings are page-aligned, so the offsets
+    // are suitably aligned to be read in place.
+    view = reinterpret_cast<const std::uint64_t*>(mapped->data() + header);
+    count = stored;
+}
+
+// Moving a RecordIndex, leaving the old one empty.
+parsical::RecordIndex::RecordIndex(parsical::RecordIndex&& other) noexcept :
+        offsets(std::move(other.offsets)),
+        mapped(std::move(other.mapped)),
+        view(other.view),
+        count(other.count) {
+    other.offsets.clear();
+    other.view = nullptr;
+    other.count = 0;
+}
+
+parsical::RecordIndex& parsical::RecordIndex::operator=(parsical::RecordIndex&& other) noexcept {
+    if (this != &other) {
+        offsets = std::move(other.offsets);
+        mapped = std::move(other.mapped);
+        view = other.view;
+        count = other.count;
+
+        other.offsets.clear();
+        other.view = nullptr;
+        other.count = 0;
+    }
+
+    return *this;
+}
+
+// Recording the start of the next record.
+void parsical::RecordIndex::add(std::uint64_t offset) throw(std::logic_error) {
+    if (mapped)
+        throw std::logic_error("Cannot add to a RecordIndex loaded from a file.");
+
+    offsets.push_back(offset);
+    view = offsets.data();
+    count = offsets.size();
+}
+
+// The number of records.
+std::size_t parsical::RecordIndex::size() const noexcept { return count; }
+
+// Where the ith record starts.
+std::uint64_t parsical::RecordIndex::operator[](std::size_t i) const noexcept { return view[i]; }
+
+// Writing the index out to a file.
+void parsical::RecordIndex::save(std::string path) const throw(std::runtime_error) {
+    std::ofstream out(path, std::ios::binary | std::ios::trunc);
+    if (!out)
+        throw std::runtime_error("Could not open record index for writing: " + path);
+
+    std::uint64_t stored = count;
+    out.write(magic, sizeof(magic));
+    out.write(reinterpret_cast<const char*>(&stored), sizeof(stored));
+    out.write(reinterpret_cast<const char*>(view), count * sizeof(std::uint64_t));
+
+    if (!out)
+        throw std::runtime_error("Could not write record index: " + path);
+}
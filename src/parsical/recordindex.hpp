@@ -0,0 +1,82 @@
+// Name: parsical/recordindex.hpp
+//
+// Description:
+//   An index of where each record in a large input starts, so that later
+//   parses can seek straight to the records they need. The index can be
+//   saved next to the input and mapped back in.
+
+#ifndef _PARSICAL_RECORD_INDEX_HPP_
+#define _PARSICAL_RECORD_INDEX_HPP_
+
+//////////////
+// Includes //
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "parsestream.hpp"
+#include "parseerror.hpp"
+#include "mappedfile.hpp"
+
+//////////
+// Code //
+
+namespace parsical {
+    // The start offsets of the records in some input, in order. A RecordIndex
+    // is either being built, by adding offsets to it, or loaded from a file
+    // saved earlier, in which case it's read straight out of a mapping of
+    // that file and can't be added to.
+    //
+    // The file is an 8-byte magic number, a 64-bit count and then each
+    // 64-bit offset, all in the machine's byte order.
+    class RecordIndex {
+    private:
+        std::vector<std::uint64_t> offsets;
+        std::unique_ptr<MappedFile> mapped;
+        const std::uint64_t* view;
+        std::size_t count;
+
+    public:
+        // Creating an empty RecordIndex to build.
+        RecordIndex();
+
+        // Loading a RecordIndex saved with save, by mapping it.
+        RecordIndex(std::string) throw(std::runtime_error);
+
+        // Moving a RecordIndex, leaving the old one empty.
+        RecordIndex(RecordIndex&&) noexcept;
+        RecordIndex& operator=(RecordIndex&&) noexcept;
+
+        // Recording the start of the next record.
+        void add(std::uint64_t) throw(std::logic_error);
+
+        // The number of records.
+        std::size_t size() const noexcept;
+
+        // Where the ith record starts.
+        std::uint64_t operator[](std::size_t) const noexcept;
+
+        // Writing the index out to a file.
+        void save(std::string) const throw(std::runtime_error);
+    };
+
+    // The same as many, but recording where each value started in a
+    // RecordIndex.
+    template <typename ReturnType,
+              typename ParserType,
+              typename FunctionType>
+    std::vector<ReturnType> indexedMany(ParseStream<ParserType>&, FunctionType, RecordIndex&) throw(ParseError);
+
+    // Seeking to the ith record in an index and parsing just that record.
+    template <typename ReturnType,
+              typename ParserType,
+              typename FunctionType>
+    ReturnType parseRecord(ParseStream<ParserType>&, const RecordIndex&, std::size_t, FunctionType) throw(ParseError);
+}
+
+#include "recordindex.tpp"
+
+#endif
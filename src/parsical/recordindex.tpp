@@ -0,0 +1,37 @@
+#include "recordindex.hpp"
+
+// The same as many, but recording where each value started in a
+// RecordIndex.
+template <typename ReturnType,
+          typename ParserType,
+          typename FunctionType>
+std::vector<ReturnType> parsical::indexedMany(parsical::ParseStream<ParserType>& stream, FunctionType fn, parsical::RecordIndex& index) throw(parsical::ParseError) {
+    std::vector<ReturnType> values;
+
+    bool good = true;
+    while (good) {
+        std::size_t start = stream.pos();
+        try {
+            values.push_back(fn(stream));
+            index.add(start);
+        } catch (parsical::ParseError& e) {
+            if (stream.failed())
+                throw;
+            good = false;
+        }
+    }
+
+    return values;
+}
+
+// Seeking to the ith record in an index and parsing just that record.
+template <typename ReturnType,
+          typename ParserType,
+          typename FunctionType>
+ReturnType parsical::parseRecord(parsical::ParseStream<ParserType>& stream, const parsical::RecordIndex& index, std::size_t i, FunctionType fn) throw(parsical::ParseError) {
+    if (i >= index.size())
+        throw parsical::ParseError(parsical::ErrorCode::BadSeek, "parseRecord: no such record.", stream.pos());
+
+    stream.seek(index[i]);
+    return fn(stream);
+}
@@ -0,0 +1,145 @@
+#include "reverseparser.hpp"
+
+//////////////
+// Includes //
+#include <algorithm>
+#include <cstring>
+
+//////////
+// Code //
+
+// Reading the byte at a forward offset, loading the block around it
+// when reading from a file.
+char parsical::ReverseParser::at(std::size_t offset) const throw(parsical::ParseError) {
+    if (data != nullptr)
+        return data[offset];
+
+    if (offset < blockStart || offset >= blockStart + block.size()) {
+        // Loading the block that ends just past the offset, since reading
+        // carries on towards the start.
+        std::size_t end = offset + 1;
+        blockStart = end > blockSize ? end - blockSize : 0;
+        block.resize(end - blockStart);
+
+        file.clear();
+        file.seekg(blockStart);
+        file.read(block.data(), block.size());
+        if (static_cast<std::size_t>(file.gcount()) != block.size()) {
+            block.clear();
+            throw parsical::ParseError(parsical::ErrorCode::Generic, "Could not read the file backwards.", pos());
+        }
+    }
+
+    return block[offset - blockStart];
+}
+
+// Reading size bytes at data backwards.
+parsical::ReverseParser::ReverseParser(const char* data, std::size_t size) :
+        data(data),
+        size(size),
+        p(0),
+        blockSize(0),
+        blockStart(0) { }
+
+// Reading a mapped file backwards.
+parsical::ReverseParser::ReverseParser(const parsical::MappedFile& file) :
+        parsical::ReverseParser(file.data(), file.size()) { }
+
+// Reading the file at the given path backwards, a block at a time.
+parsical::ReverseParser::ReverseParser(std::string path, std::size_t blockSize) throw(std::runtime_error) :
+        data(nullptr),
+        size(0),
+        p(0),
+        file(path, std::ios::binary),
+        blockSize(std::max<std::size_t>(blockSize, 1)),
+        blockStart(0) {
+    if (!file)
+        throw std::runtime_error("Could not open file: " + path);
+
+    file.seekg(0, std::ios::end);
+    size = static_cast<std::size_t>(file.tellg());
+}
+
+// The forward offset just past the next byte to be read - the size
+// of the input less the current position.
+std::size_t parsical::ReverseParser::offset() const noexcept { return size - p; }
+
+// Reading backwards through the previous occurrence of a delimiter, or
+// to the start of the input, and returning the forward offset just
+// after it. That's where the record that ends at the current offset
+// starts.
+std::size_t parsical::ReverseParser::previousRecordStart(char delimiter) throw(parsical::ParseError) {
+    // Over memory, memrchr does the scanning in one go.
+    if (data != nullptr) {
+        const void* found = memrchr(data, delimiter, offset());
+        std::size_t start = found == nullptr ? 0 : static_cast<const char*>(found) - data + 1;
+        p = found == nullptr ? size : size - start + 1;
+        return start;
+    }
+
+    // Over a file, a block at a time.
+    while (!eof()) {
+        std::size_t end = offset();
+        at(end - 1);
+
+        const void* found = memrchr(block.data(), delimiter, end - blockStart);
+        if (found != nullptr) {
+            std::size_t start = blockStart + (static_cast<const char*>(found) - block.data()) + 1;
+            p = size - start + 1;
+            return start;
+        }
+
+        p = size - blockStart;
+    }
+
+    return 0;
+}
+
+// Checking whether this ParseStream has reached its end.
+bool parsical::ReverseParser::eof() const noexcept { return p >= size; }
+
+// Peeking at the next value without consuming it.
+char parsical::ReverseParser::peek() const throw(parsical::ParseError) {
+    if (eof())
+        throw parsical::ParseError(parsical::ErrorCode::EndOfInput, "Cannot peek after EOF has been reached.", pos());
+    return at(size - p - 1);
+}
+
+// Getting the current position in this ParseStream.
+std::size_t parsical::ReverseParser::pos() const noexcept { return p; }
+
+// Consuming and returning a value.
+char parsical::ReverseParser::get() throw(parsical::ParseError) {
+    if (eof())
+        throw parsical::ParseError(parsical::ErrorCode::EndOfInput, "Cannot get after EOF has been reached.", pos());
+    char c = at(size - p - 1);
+    p++;
+    return c;
+}
+
+// Stepping back some interval.
+void parsical::ReverseParser::stepBack(std::size_t n) throw(parsical::ParseError) {
+    if (n > pos())
+        throw parsical::ParseError(parsical::ErrorCode::BadStepBack, "Stepping back so far would make the current position negative.", pos());
+    p -= n;
+}
+
+// Finding the [start, end) bounds of the last n records of an input
+// whose records each end with a delimiter, reading backwards from the
+// current position of a ReverseParser. The latest record comes first.
+std::vector<std::pair<std::size_t, std::size_t>> parsical::tailBounds(parsical::ReverseParser& reverse, char delimiter, std::size_t n) throw(parsical::ParseError) {
+    std::vector<std::pair<std::size_t, std::size_t>> bounds;
+
+    // The delimiter ending the last record doesn't start a new one.
+    std::size_t end = reverse.offset();
+    if (!reverse.eof() && reverse.peek() == delimiter)
+        reverse.get();
+
+    while (bounds.size() < n && !reverse.eof()) {
+        std::size_t start = reverse.previousRecordStart(delimiter);
+        bounds.push_back(std::make_pair(start, end));
+        end = start;
+    }
+
+    return bounds;
+}
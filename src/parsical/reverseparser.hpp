@@ -0,0 +1,114 @@
+// Name: parsical/reverseparser.hpp
+//
+// Description:
+//   A ParseStream that reads its input from the end back to the start, for
+//   getting at the last few records of a large file without reading the
+//   rest of it.
+
+#ifndef _PARSICAL_REVERSE_PARSER_HPP_
+#define _PARSICAL_REVERSE_PARSER_HPP_
+
+//////////////
+// Includes //
+#include <cstddef>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "parsestream.hpp"
+#include "parseerror.hpp"
+#include "iteratorparser.hpp"
+#include "mappedfile.hpp"
+
+//////////
+// Code //
+
+namespace parsical {
+    // Yields the bytes of some input last first. Positions count bytes read
+    // from the end, like any other stream; offset gives the forward offset
+    // into the input instead.
+    //
+    // Over memory the bytes are read in place. Over a file they're read a
+    // block at a time, working backwards, so only the blocks actually reached
+    // are ever read.
+    class ReverseParser : public ParseStream<char> {
+    private:
+        const char* data;
+        std::size_t size;
+        std::size_t p;
+
+        mutable std::ifstream file;
+        std::size_t blockSize;
+        mutable std::vector<char> block;
+        mutable std::size_t blockStart;
+
+        // Reading the byte at a forward offset, loading the block around it
+        // when reading from a file.
+        char at(std::size_t) const throw(ParseError);
+
+    public:
+        // Reading size bytes at data backwards.
+        ReverseParser(const char*, std::size_t);
+
+        // Reading a mapped file backwards.
+        ReverseParser(const MappedFile&);
+
+        // Reading the file at the given path backwards, a block at a time.
+        ReverseParser(std::string, std::size_t blockSize = 1 << 16) throw(std::runtime_error);
+
+        // The forward offset just past the next byte to be read - the size
+        // of the input less the current position.
+        std::size_t offset() const noexcept;
+
+        // Reading backwards through the previous occurrence of a delimiter, or
+        // to the start of the input, and returning the forward offset just
+        // after it. That's where the record that ends at the current offset
+        // starts.
+        std::size_t previousRecordStart(char) throw(ParseError);
+
+        // Checking whether this ParseStream has reached its end.
+        virtual bool eof() const noexcept override;
+
+        // Peeking at the next value without consuming it.
+        virtual char peek() const throw(ParseError) override;
+
+        // Getting the current position in this ParseStream.
+        virtual std::size_t pos() const noexcept override;
+
+        // Consuming and returning a value.
+        virtual char get() throw(ParseError) override;
+
+        // Stepping back some interval.
+        virtual void stepBack(std::size_t) throw(ParseError) override;
+    };
+
+    // Finding the [start, end) bounds of the last n records of an input
+    // whose records each end with a delimiter, reading backwards from the
+    // current position of a ReverseParser. The latest record comes first.
+    std::vector<std::pair<std::size_t, std::size_t>> tailBounds(ReverseParser&, char, std::size_t) throw(ParseError);
+
+    // Finding the last n records of an input whose records each end with a
+    // delimiter, and parsing them forwards. They're returned in the order
+    // they appear in the input. Each record is handed to the parser with its
+    // delimiter, and with positions that are offsets into the whole input.
+    template <typename ReturnType,
+              typename FunctionType>
+    std::vector<ReturnType> tailRecords(const char*, std::size_t, char, std::size_t, FunctionType) throw(ParseError);
+
+    template <typename ReturnType,
+              typename FunctionType>
+    std::vector<ReturnType> tailRecords(const MappedFile&, char, std::size_t, FunctionType) throw(ParseError);
+
+    // The same as above, over a file that's read rather than mapped. Each
+    // record is read in whole before it's parsed, so the parser still can't
+    // see past its end.
+    template <typename ReturnType,
+              typename FunctionType>
+    std::vector<ReturnType> tailRecords(std::string, char, std::size_t, FunctionType) throw(ParseError, std::runtime_error);
+}
+
+#include "reverseparser.tpp"
+
+#endif
@@ -0,0 +1,69 @@
+#include "reverseparser.hpp"
+
+// Finding the last n records of an input whose records each end with a
+// delimiter, and parsing them forwards. They're returned in the order
+// they appear in the input. Each record is handed to the parser with its
+// delimiter, and with positions that are offsets into the whole input.
+template <typename ReturnType,
+          typename FunctionType>
+std::vector<ReturnType> parsical::tailRecords(const char* data, std::size_t size, char delimiter, std::size_t n, FunctionType fn) throw(parsical::ParseError) {
+    parsical::ReverseParser reverse(data, size);
+    std::vector<std::pair<std::size_t, std::size_t>> bounds = parsical::tailBounds(reverse, delimiter, n);
+
+    std::vector<ReturnType> values;
+    values.reserve(bounds.size());
+
+    parsical::IteratorParser<const char*> stream(data, data);
+    for (std::size_t i = bounds.size(); i-- > 0;) {
+        stream.reset(data + bounds[i].first, data + bounds[i].second, bounds[i].first);
+        values.push_back(fn(stream));
+    }
+
+    return values;
+}
+
+template <typename ReturnType,
+          typename FunctionType>
+std::vector<ReturnType> parsical::tailRecords(const parsical::MappedFile& file, char delimiter, std::size_t n, FunctionType fn) throw(parsical::ParseError) {
+    return parsical::tailRecords<ReturnType>(file.data(), file.size(), delimiter, n, fn);
+}
+
+// The same as above, over a file that's read rather than mapped. Each
+// record is read in whole before it's parsed, so the parser still can't
+// see past its end.
+template <typename ReturnType,
+          typename FunctionType>
+std::vector<ReturnType> parsical::tailRecords(std::string path, char delimiter, std::size_t n, FunctionType fn) throw(parsical::ParseError, std::runtime_error) {
+    std::vector<std::pair<std::size_t, std::size_t>> bounds;
+    {
+        parsical::ReverseParser reverse(path);
+        bounds = parsical::tailBounds(reverse, delimiter, n);
+    }
+
+    std::vector<ReturnType> values;
+    values.reserve(bounds.size());
+
+    if (bounds.empty())
+        return values;
+
+    std::ifstream in(path, std::ios::binary);
+    if (!in.good())
+        throw std::runtime_error("Could not open file " + path + ".");
+
+    std::vector<char> record;
+    parsical::IteratorParser<const char*> stream(nullptr, nullptr);
+    for (std::size_t i = bounds.size(); i-- > 0;) {
+        std::size_t size = bounds[i].second - bounds[i].first;
+        record.resize(size);
+
+        in.seekg(static_cast<std::streamoff>(bounds[i].first));
+        in.read(record.data(), static_cast<std::streamsize>(size));
+        if (static_cast<std::size_t>(in.gcount()) != size)
+            throw parsical::ParseError(parsical::ErrorCode::Generic, "Could not read the record.", bounds[i].first);
+
+        stream.reset(record.data(), record.data() + size, bounds[i].first);
+        values.push_back(fn(stream));
+    }
+
+    return values;
+}
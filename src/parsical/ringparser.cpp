@@ -0,0 +1,335 @@
+#include "ringparser.hpp"
+
+//////////////
+// Includes //
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+
+//////////
+// Code //
+
+////
+// RingBuffer
+
+// Creating a RingBuffer that holds at least the given number of
+// values. The capacity is rounded up to a power of two.
+parsical::RingBuffer::RingBuffer(std::size_t capacity) throw(std::runtime_error) :
+        head(0),
+        tail(0),
+        closed(false),
+        abandoned(false),
+        producerWaiting(false),
+        consumerWaiting(false) {
+    if (capacity == 0)
+        throw std::runtime_error("RingBuffer capacity must be positive.");
+
+    std::size_t size = 1;
+    while (size < capacity)
+        size <<= 1;
+
+    buffer.resize(size);
+    mask = size - 1;
+}
+
+// Waking whichever side is blocked waiting on the other.
+void parsical::RingBuffer::wake() noexcept {
+    // Taking the lock means a waiter is either yet to check its condition,
+    // or already waiting - so the notification can't be missed.
+    { std::lock_guard<std::mutex> guard(lock); }
+    changed.notify_all();
+}
+
+// The number of values the RingBuffer can hold.
+std::size_t parsical::RingBuffer::capacity() const noexcept { return buffer.size(); }
+
+// Writing as much of the given data as currently fits without
+// waiting. Returns the number of values written. Producer only.
+std::size_t parsical::RingBuffer::write(const char* data, std::size_t size) noexcept {
+    std::size_t h = head.load(std::memory_order_relaxed);
+    std::size_t t = tail.load(std::memory_order_acquire);
+    std::size_t n = std::min(size, capacity() - (h - t));
+    if (n == 0)
+        return 0;
+
+    // Copying in at most two pieces - up to the end of the buffer, and then
+    // around from the front.
+    std::size_t at = h & mask;
+    std::size_t first = std::min(n, capacity() - at);
+    std::memcpy(&buffer[at], data, first);
+    std::memcpy(&buffer[0], data + first, n - first);
+
+    head.store(h + n);
+    if (consumerWaiting.load())
+        wake();
+    return n;
+}
+
+// Writing all of the given data, blocking while the buffer is full.
+// Gives up if the consumer abandons the buffer. Producer only.
+void parsical::RingBuffer::writeAll(const char* data, std::size_t size) noexcept {
+    while (size > 0 && waitForSpace()) {
+        std::size_t n = write(data, size);
+        data += n;
+        size -= n;
+    }
+}
+
+// Blocking until there's free space to write into, or the consumer
+// has abandoned the buffer. Returns whether there's space. Producer
+// only.
+bool parsical::RingBuffer::waitForSpace() noexcept {
+    std::size_t h = head.load(std::memory_order_relaxed);
+    if (h - tail.load(std::memory_order_acquire) < capacity())
+        return true;
+
+    // The flag has to be set before checking again, and the consumer stores
+    // tail before checking the flag, so one of them always sees the other.
+    producerWaiting.store(true);
+    {
+        std::unique_lock<std::mutex> guard(lock);
+        changed.wait(guard, [this, h]() {
+            return h - tail.load() < capacity() || abandoned.load();
+        });
+    }
+    producerWaiting.store(false);
+
+    return !abandoned.load();
+}
+
+// Getting a pointer to the contiguous free space at the end of the
+// buffer, so the producer can read straight into it. Returns how many
+// values fit there - possibly 0. Producer only.
+std::size_t parsical::RingBuffer::reserve(char** at) noexcept {
+    std::size_t h = head.load(std::memory_order_relaxed);
+    std::size_t t = tail.load(std::memory_order_acquire);
+
+    *at = &buffer[h & mask];
+    return std::min(capacity() - (h - t), capacity() - (h & mask));
+}
+
+// Publishing the first n values written into the space handed out by
+// reserve. Producer only.
+void parsical::RingBuffer::commit(std::size_t n) noexcept {
+    head.store(head.load(std::memory_order_relaxed) + n);
+    if (consumerWaiting.load())
+        wake();
+}
+
+// Marking that the producer is done. Once the consumer has read
+// everything that was written, it will see EOF.
+void parsical::RingBuffer::close() noexcept {
+    closed.store(true);
+    wake();
+}
+
+// Marking that nothing more is going to be read, so that a producer
+// waiting for space stops waiting.
+void parsical::RingBuffer::abandon() noexcept {
+    abandoned.store(true);
+    wake();
+}
+
+////
+// RingParser
+
+// Waiting until there are values up to the given position, or the
+// producer has closed the buffer. Returns whether there are.
+bool parsical::RingParser::waitFor(std::size_t end) const noexcept {
+    if (end <= known)
+        return true;
+
+    known = ring.head.load(std::memory_order_acquire);
+    touch();
+    if (end <= known)
+        return true;
+
+    // Only timing the slow path, where the producer hasn't caught up. As
+    // with the producer, the flag goes up before head is checked again.
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    ring.consumerWaiting.store(true);
+    {
+        std::unique_lock<std::mutex> guard(ring.lock);
+        ring.changed.wait(guard, [this, end]() {
+            known = ring.head.load();
+            return end <= known || ring.closed.load();
+        });
+    }
+    ring.consumerWaiting.store(false);
+
+    // Everything written before close() is visible once closed is, so head
+    // has to be checked one more time.
+    known = ring.head.load(std::memory_order_acquire);
+
+    waited += std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    touch();
+    return end <= known;
+}
+
+// Handing space the backtrack window has passed back to the
+// producer, in batches so the consumer isn't writing to the shared
+// tail on every single value.
+void parsical::RingParser::release() noexcept {
+    std::size_t batch = std::max<std::size_t>(1, (ring.capacity() - window) / 4);
+    if (p < floor.position() + window + batch)
+        return;
+
+    floor.move(p - window);
+    publish();
+}
+
+// Handing back the space before every cursor's floor - this one's
+// and its forks'.
+void parsical::RingParser::publish() noexcept {
+    std::size_t lowest = floor.group()->lowest(floor.position());
+    if (lowest <= ring.tail.load(std::memory_order_relaxed))
+        return;
+
+    ring.tail.store(lowest);
+    if (ring.producerWaiting.load())
+        ring.wake();
+}
+
+// Noting that the parser is in use right now, for activeSeconds.
+void parsical::RingParser::touch() const noexcept {
+    lastActive = std::chrono::steady_clock::now();
+    if (!active) {
+        firstActive = lastActive;
+        active = true;
+    }
+}
+
+// Creating a RingParser over a RingBuffer with a given backtrack
+// window. The window has to be smaller than the buffer's capacity.
+parsical::RingParser::RingParser(parsical::RingBuffer& ring, std::size_t window) throw(std::runtime_error) :
+        ring(ring),
+        window(window),
+        floor(std::make_shared<parsical::PinSet>(), 0),
+        p(0),
+        known(0),
+        waited(0),
+        active(false) {
+    if (window >= ring.capacity())
+        throw std::runtime_error("RingParser backtrack window must be smaller than the RingBuffer.");
+}
+
+// The total time, in seconds, this RingParser has spent waiting on the
+// producer.
+double parsical::RingParser::waitSeconds() const noexcept { return waited; }
+
+// The time, in seconds, between this RingParser first and most
+// recently going to the buffer for more input - roughly how long it
+// has been in use, as opposed to how long it has existed.
+double parsical::RingParser::activeSeconds() const noexcept {
+    return std::chrono::duration<double>(lastActive - firstActive).count();
+}
+
+// Checking whether this ParseStream has reached its end. This blocks
+// until either more input or the end of input is available.
+bool parsical::RingParser::eof() const noexcept { return !waitFor(p + 1); }
+
+// Peeking at the next value without consuming it.
+char parsical::RingParser::peek() const throw(parsical::ParseError) {
+    if (!waitFor(p + 1))
+        throw parsical::ParseError(parsical::ErrorCode::EndOfInput, "Cannot peek after EOF has been reached.", pos());
+    return ring.buffer[p & ring.mask];
+}
+
+// Getting the current position in this ParseStream.
+std::size_t parsical::RingParser::pos() const noexcept { return p; }
+
+// Consuming and returning a value.
+char parsical::RingParser::get() throw(parsical::ParseError) {
+    if (!waitFor(p + 1))
+        throw parsical::ParseError(parsical::ErrorCode::EndOfInput, "Cannot get after EOF has been reached.", pos());
+    char c = ring.buffer[p & ring.mask];
+    p++;
+    release();
+
+    return c;
+}
+
+// Stepping back some interval.
+void parsical::RingParser::stepBack(std::size_t n) throw(parsical::ParseError) {
+    if (n > pos())
+        throw parsical::ParseError(parsical::ErrorCode::BadStepBack, "Stepping back so far would make the current position negative.", pos());
+    if (p - n < floor.position())
+        throw parsical::ParseError(parsical::ErrorCode::BadStepBack, "Cannot step back past the RingParser's backtrack window.", pos());
+    p -= n;
+}
+
+// Handing the space before the given position back to the producer
+// early, rather than waiting for the backtrack window to pass it.
+void parsical::RingParser::discardBefore(std::size_t position) noexcept {
+    position = std::min(position, p);
+    if (position <= floor.position())
+        return;
+
+    floor.move(position);
+    publish();
+}
+
+// Whether ensure, peekN and advance work on a buffer.
+bool parsical::RingParser::buffered() const noexcept { return true; }
+
+// Checking that at least n more values are available, waiting for
+// the producer if need be. Looking further ahead than the buffer can
+// hold past the backtrack window is an error.
+bool parsical::RingParser::ensure(std::size_t n) {
+    if (p + n > ring.tail.load(std::memory_order_relaxed) + ring.capacity()) {
+        // Giving back everything the backtrack window allows, in case that
+        // makes enough room.
+        if (p > floor.position() + window) {
+            floor.move(p - window);
+            publish();
+        }
+
+        if (p + n > ring.tail.load(std::memory_order_relaxed) + ring.capacity())
+            throw parsical::ParseError(parsical::ErrorCode::Generic, "Cannot look further ahead than the RingBuffer holds.", pos());
+    }
+
+    return waitFor(p + n);
+}
+
+// Looking at the next n values without consuming them. They're only
+// copied if they wrap around the end of the buffer.
+parsical::Span<char> parsical::RingParser::peekN(std::size_t n) throw(parsical::ParseError) {
+    if (!ensure(n))
+        throw parsical::ParseError(parsical::ErrorCode::EndOfInput, "Cannot peek past EOF.", pos());
+
+    std::size_t at = p & ring.mask;
+    if (at + n <= ring.capacity())
+        return parsical::Span<char>(&ring.buffer[at], n);
+
+    std::size_t first = ring.capacity() - at;
+    scratch.resize(n);
+    std::memcpy(scratch.data(), &ring.buffer[at], first);
+    std::memcpy(scratch.data() + first, &ring.buffer[0], n - first);
+    return parsical::Span<char>(scratch.data(), n);
+}
+
+// Consuming the next n values.
+void parsical::RingParser::advance(std::size_t n) throw(parsical::ParseError) {
+    if (!ensure(n))
+        throw parsical::ParseError(parsical::ErrorCode::EndOfInput, "Cannot advance past EOF.", pos());
+    p += n;
+    release();
+}
+
+// Consuming and returning a value, without checking for the end of
+// the stream.
+char parsical::RingParser::getUnchecked() {
+    char c = ring.buffer[p & ring.mask];
+    p++;
+    release();
+
+    return c;
+}
+
+// Making a cursor at the same position over the same RingBuffer,
+// able to step back as far as this one can.
+std::unique_ptr<parsical::ParseStream<char>> parsical::RingParser::fork() const {
+    std::unique_ptr<parsical::RingParser> forked(new parsical::RingParser(*this));
+    forked->scratch.clear();
+    return std::move(forked);
+}
@@ -0,0 +1,206 @@
+// Name: parsical/ringparser.hpp
+//
+// Description:
+//   A lock-free, single-producer / single-consumer ring buffer, and a
+//   ParseStream that consumes from it. This lets one thread read input (from
+//   disk, a socket, ...) while another thread parses it.
+
+#ifndef _PARSICAL_RING_PARSER_HPP_
+#define _PARSICAL_RING_PARSER_HPP_
+
+//////////////
+// Includes //
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <mutex>
+#include <stdexcept>
+#include <vector>
+
+#include "parsestream.hpp"
+#include "parseerror.hpp"
+#include "pins.hpp"
+
+//////////
+// Code //
+
+// The size of a cache line, used to keep the producer's and the consumer's
+// indices from sharing one.
+#ifndef PARSICAL_CACHE_LINE
+#define PARSICAL_CACHE_LINE 64
+#endif
+
+namespace parsical {
+    // The shared buffer between a producer thread and a RingParser. Exactly
+    // one thread may write to it and exactly one RingParser may read from it.
+    //
+    // Both head and tail only ever grow; they're masked down into the buffer
+    // when it's indexed.
+    //
+    // Neither side spins while it waits on the other: a producer that finds
+    // the buffer full, or a consumer that finds it empty, flags that it's
+    // waiting and blocks on a condition variable, which the other side only
+    // touches when that flag is set.
+    class RingBuffer {
+    private:
+        friend class RingParser;
+
+        std::vector<char> buffer;
+        std::size_t mask;
+
+        char headPadding[PARSICAL_CACHE_LINE];
+        std::atomic<std::size_t> head;
+        char tailPadding[PARSICAL_CACHE_LINE - sizeof(std::atomic<std::size_t>)];
+        std::atomic<std::size_t> tail;
+        char closedPadding[PARSICAL_CACHE_LINE - sizeof(std::atomic<std::size_t>)];
+        std::atomic<bool> closed;
+        std::atomic<bool> abandoned;
+        std::atomic<bool> producerWaiting;
+        std::atomic<bool> consumerWaiting;
+
+        std::mutex lock;
+        std::condition_variable changed;
+
+        // Waking whichever side is blocked waiting on the other.
+        void wake() noexcept;
+
+    public:
+        // Creating a RingBuffer that holds at least the given number of
+        // values. The capacity is rounded up to a power of two.
+        RingBuffer(std::size_t) throw(std::runtime_error);
+
+        // The number of values the RingBuffer can hold.
+        std::size_t capacity() const noexcept;
+
+        // Writing as much of the given data as currently fits without
+        // waiting. Returns the number of values written. Producer only.
+        std::size_t write(const char*, std::size_t) noexcept;
+
+        // Writing all of the given data, blocking while the buffer is full.
+        // Gives up if the consumer abandons the buffer. Producer only.
+        void writeAll(const char*, std::size_t) noexcept;
+
+        // Blocking until there's free space to write into, or the consumer
+        // has abandoned the buffer. Returns whether there's space. Producer
+        // only.
+        bool waitForSpace() noexcept;
+
+        // Getting a pointer to the contiguous free space at the end of the
+        // buffer, so the producer can read straight into it. Returns how many
+        // values fit there - possibly 0. Producer only.
+        std::size_t reserve(char**) noexcept;
+
+        // Publishing the first n values written into the space handed out by
+        // reserve. Producer only.
+        void commit(std::size_t) noexcept;
+
+        // Marking that the producer is done. Once the consumer has read
+        // everything that was written, it will see EOF.
+        void close() noexcept;
+
+        // Marking that nothing more is going to be read, so that a producer
+        // waiting for space stops waiting.
+        void abandon() noexcept;
+    };
+
+    // A ParseStream reading from a RingBuffer. It only blocks when it has
+    // caught up with the producer.
+    //
+    // The RingParser keeps a bounded backtrack window: it is always possible
+    // to step back at least that far, but anything further back may already
+    // have been overwritten by the producer.
+    //
+    // Forks hold on to the space they can step back to until they're
+    // destroyed, so a long-lived fork that falls behind will stall the
+    // producer. Only one thread can read from a RingBuffer, so forks have to
+    // be used from the same thread as the RingParser they were made from.
+    class RingParser : public ParseStream<char> {
+    private:
+        RingBuffer& ring;
+        std::size_t window;
+        Pin floor;
+        std::size_t p;
+        std::vector<char> scratch;
+        mutable std::size_t known;
+        mutable double waited;
+        mutable bool active;
+        mutable std::chrono::steady_clock::time_point firstActive;
+        mutable std::chrono::steady_clock::time_point lastActive;
+
+        // Waiting until there are values up to the given position, or the
+        // producer has closed the buffer. Returns whether there are.
+        bool waitFor(std::size_t) const noexcept;
+
+        // Handing space the backtrack window has passed back to the
+        // producer, in batches so the consumer isn't writing to the shared
+        // tail on every single value.
+        void release() noexcept;
+
+        // Handing back the space before every cursor's floor - this one's
+        // and its forks'.
+        void publish() noexcept;
+
+        // Noting that the parser is in use right now, for activeSeconds.
+        void touch() const noexcept;
+
+    public:
+        // Creating a RingParser over a RingBuffer with a given backtrack
+        // window. The window has to be smaller than the buffer's capacity.
+        RingParser(RingBuffer&, std::size_t) throw(std::runtime_error);
+
+        // The total time, in seconds, this RingParser has spent waiting on the
+        // producer.
+        double waitSeconds() const noexcept;
+
+        // The time, in seconds, between this RingParser first and most
+        // recently going to the buffer for more input - roughly how long it
+        // has been in use, as opposed to how long it has existed.
+        double activeSeconds() const noexcept;
+
+        // Checking whether this ParseStream has reached its end. This blocks
+        // until either more input or the end of input is available.
+        virtual bool eof() const noexcept override;
+
+        // Peeking at the next value without consuming it.
+        virtual char peek() const throw(ParseError) override;
+
+        // Getting the current position in this ParseStream.
+        virtual std::size_t pos() const noexcept override;
+
+        // Consuming and returning a value.
+        virtual char get() throw(ParseError) override;
+
+        // Stepping back some interval.
+        virtual void stepBack(std::size_t) throw(ParseError) override;
+
+        // Handing the space before the given position back to the producer
+        // early, rather than waiting for the backtrack window to pass it.
+        virtual void discardBefore(std::size_t) noexcept override;
+
+        // Whether ensure, peekN and advance work on a buffer.
+        virtual bool buffered() const noexcept override;
+
+        // Checking that at least n more values are available, waiting for
+        // the producer if need be. Looking further ahead than the buffer can
+        // hold past the backtrack window is an error.
+        virtual bool ensure(std::size_t) override;
+
+        // Looking at the next n values without consuming them. They're only
+        // copied if they wrap around the end of the buffer.
+        virtual Span<char> peekN(std::size_t) throw(ParseError) override;
+
+        // Consuming the next n values.
+        virtual void advance(std::size_t) throw(ParseError) override;
+
+        // Consuming and returning a value, without checking for the end of
+        // the stream.
+        virtual char getUnchecked() override;
+
+        // Making a cursor at the same position over the same RingBuffer,
+        // able to step back as far as this one can.
+        virtual std::unique_ptr<ParseStream<char>> fork() const override;
+    };
+}
+
+#endif
@@ -0,0 +1,167 @@
+#include "segmentedparser.hpp"
+
+//////////////
+// Includes //
+#include <algorithm>
+
+//////////
+// Code //
+
+// Moving on to the next segment if the current one is exhausted.
+void parsical::SegmentedParser::normalize() noexcept {
+    if (seg < segments.size() && offset >= segments[seg].size) {
+        seg++;
+        offset = 0;
+    }
+}
+
+// Constructing a SegmentedParser from a list of segments. Empty
+// segments are skipped.
+parsical::SegmentedParser::SegmentedParser(std::vector<parsical::Segment> in) :
+        seg(0),
+        offset(0),
+        p(0),
+        total(0) {
+    std::size_t start = 0;
+    for (const parsical::Segment& s: in) {
+        if (s.size == 0)
+            continue;
+
+        segments.push_back(s);
+        starts.push_back(start);
+        start += s.size;
+    }
+
+    total = start;
+}
+
+// Checking whether this ParseStream has reached its end.
+bool parsical::SegmentedParser::eof() const noexcept {
+    return seg >= segments.size();
+}
+
+// Peeking at the next value without consuming it.
+char parsical::SegmentedParser::peek() const throw(parsical::ParseError) {
+    if (eof())
+        throw parsical::ParseError(parsical::ErrorCode::EndOfInput, "Cannot peek after EOF has been reached.", pos());
+    return segments[seg].data[offset];
+}
+
+// Getting the current position in this ParseStream.
+std::size_t parsical::SegmentedParser::pos() const noexcept { return p; }
+
+// Consuming and returning a value.
+char parsical::SegmentedParser::get() throw(parsical::ParseError) {
+    if (eof())
+        throw parsical::ParseError(parsical::ErrorCode::EndOfInput, "Cannot get after EOF has been reached.", pos());
+
+    char c = segments[seg].data[offset++];
+    p++;
+    normalize();
+
+    return c;
+}
+
+// Stepping back some interval.
+void parsical::SegmentedParser::stepBack(std::size_t n) throw(parsical::ParseError) {
+    if (n > pos())
+        throw parsical::ParseError(parsical::ErrorCode::BadStepBack, "Stepping back so far would make the current position negative.", pos());
+
+    p -= n;
+    if (n <= offset) {
+        offset -= n;
+        return;
+    }
+
+    seg = (std::upper_bound(starts.begin(), starts.end(), p) - starts.begin()) - 1;
+    offset = p - starts[seg];
+}
+
+// Whether ensure, peekN and advance work on a buffer.
+bool parsical::SegmentedParser::buffered() const noexcept { return true; }
+
+// Whether any earlier position can be stepped back to.
+bool parsical::SegmentedParser::rewindable() const noexcept { return true; }
+
+// Checking that at least n more values are available.
+bool parsical::SegmentedParser::ensure(std::size_t n) {
+    return total - p >= n;
+}
+
+// Peeking at the next n values without consuming them. The Span
+// points straight into the segment when the values don't cross a
+// segment boundary, and into an internal buffer when they do. Either
+// way it's only valid until the next call to peekN.
+parsical::Span<char> parsical::SegmentedParser::peekN(std::size_t n) throw(parsical::ParseError) {
+    if (n == 0)
+        return parsical::Span<char>();
+    if (eof())
+        throw parsical::ParseError(parsical::ErrorCode::EndOfInput, "Cannot peek after EOF has been reached.", pos());
+
+    const parsical::Segment& s = segments[seg];
+    if (offset + n <= s.size)
+        return parsical::Span<char>(s.data + offset, n);
+
+    scratch.clear();
+    std::size_t i = seg;
+    std::size_t from = offset;
+    while (scratch.size() < n) {
+        if (i >= segments.size())
+            throw parsical::ParseError(parsical::ErrorCode::EndOfInput, "Cannot peek past EOF.", pos());
+
+        std::size_t want = std::min(segments[i].size - from, n - scratch.size());
+        scratch.append(segments[i].data + from, want);
+        from = 0;
+        i++;
+    }
+
+    return parsical::Span<char>(scratch.data(), scratch.size());
+}
+
+// Consuming the next n values.
+void parsical::SegmentedParser::advance(std::size_t n) throw(parsical::ParseError) {
+    if (!ensure(n))
+        throw parsical::ParseError(parsical::ErrorCode::EndOfInput, "Cannot advance past EOF.", pos());
+
+    p += n;
+    while (n > 0) {
+        std::size_t step = std::min(n, segments[seg].size - offset);
+        offset += step;
+        n -= step;
+        normalize();
+    }
+}
+
+// Consuming and returning a value, without checking for the end of
+// the stream.
+char parsical::SegmentedParser::getUnchecked() {
+    char c = segments[seg].data[offset++];
+    p++;
+    normalize();
+
+    return c;
+}
+
+// Moving to an absolute position, by binary search over the segment
+// starts.
+void parsical::SegmentedParser::seek(std::size_t position) throw(parsical::ParseError) {
+    if (position > total)
+        throw parsical::ParseError(parsical::ErrorCode::BadSeek, "Cannot seek past EOF.", pos());
+
+    p = position;
+    resetCut();
+    if (position == total) {
+        seg = segments.size();
+        offset = 0;
+        return;
+    }
+
+    seg = (std::upper_bound(starts.begin(), starts.end(), p) - starts.begin()) - 1;
+    offset = p - starts[seg];
+}
+
+// Making a SegmentedParser at the same position. The list of segments
+// is copied, but not the data they point to.
+std::unique_ptr<parsical::ParseStream<char>> parsical::SegmentedParser::fork() const {
+    return std::unique_ptr<parsical::ParseStream<char>>(new parsical::SegmentedParser(*this));
+}
@@ -0,0 +1,100 @@
+// Name: parsical/segmentedparser.hpp
+//
+// Description:
+//   A ParseStream that walks a list of non-contiguous chunks (like an iovec)
+//   as if they were a single string, without concatenating them.
+
+#ifndef _PARSICAL_SEGMENTED_PARSER_HPP_
+#define _PARSICAL_SEGMENTED_PARSER_HPP_
+
+//////////////
+// Includes //
+#include <cstddef>
+#include <string>
+#include <vector>
+
+#include "parsestream.hpp"
+#include "parseerror.hpp"
+#include "span.hpp"
+
+//////////
+// Code //
+
+namespace parsical {
+    // A single chunk of input. The memory is owned by the caller and has to
+    // outlive any SegmentedParser built on top of it.
+    struct Segment {
+        const char* data;
+        std::size_t size;
+    };
+
+    // A parser over a list of Segments. It caches the segment it's currently
+    // in so that get / peek stay a pointer bump, and only falls back to a
+    // binary search over the segment starts when stepping back out of the
+    // current segment.
+    class SegmentedParser : public ParseStream<char> {
+    private:
+        std::vector<Segment> segments;
+        std::vector<std::size_t> starts;
+        std::string scratch;
+        std::size_t seg;
+        std::size_t offset;
+        std::size_t p;
+        std::size_t total;
+
+        // Moving on to the next segment if the current one is exhausted.
+        void normalize() noexcept;
+
+    public:
+        // Constructing a SegmentedParser from a list of segments. Empty
+        // segments are skipped.
+        SegmentedParser(std::vector<Segment>);
+
+        // Checking whether this ParseStream has reached its end.
+        virtual bool eof() const noexcept override;
+
+        // Peeking at the next value without consuming it.
+        virtual char peek() const throw(ParseError) override;
+
+        // Getting the current position in this ParseStream.
+        virtual std::size_t pos() const noexcept override;
+
+        // Consuming and returning a value.
+        virtual char get() throw(ParseError) override;
+
+        // Stepping back some interval.
+        virtual void stepBack(std::size_t) throw(ParseError) override;
+
+        // Whether ensure, peekN and advance work on a buffer.
+        virtual bool buffered() const noexcept override;
+
+        // Whether any earlier position can be stepped back to.
+        virtual bool rewindable() const noexcept override;
+
+        // Checking that at least n more values are available.
+        virtual bool ensure(std::size_t) override;
+
+        // Peeking at the next n values without consuming them. The Span
+        // points straight into the segment when the values don't cross a
+        // segment boundary, and into an internal buffer when they do. Either
+        // way it's only valid until the next call to peekN.
+        virtual Span<char> peekN(std::size_t) throw(ParseError) override;
+
+        // Consuming the next n values.
+        virtual void advance(std::size_t) throw(ParseError) override;
+
+        // Consuming and returning a value, without checking for the end of
+        // the stream.
+        virtual char getUnchecked() override;
+
+        // Moving to an absolute position, by binary search over the segment
+        // starts.
+        virtual void seek(std::size_t) throw(ParseError) override;
+
+        // Making a SegmentedParser at the same position. The list of segments
+        // is copied, but not the data they point to.
+        virtual std::unique_ptr<ParseStream<char>> fork() const override;
+    };
+}
+
+#endif
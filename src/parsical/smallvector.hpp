@@ -0,0 +1,110 @@
+// Name: parsical/smallvector.hpp
+//
+// Description:
+//   A vector that keeps its first few values inline, so that short results
+//   don't have to touch the heap at all.
+
+#ifndef _PARSICAL_SMALL_VECTOR_HPP_
+#define _PARSICAL_SMALL_VECTOR_HPP_
+
+//////////////
+// Includes //
+#include <algorithm>
+#include <cstddef>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+//////////
+// Code //
+
+namespace parsical {
+    // A vector with room for N values inside of the object itself. It only
+    // allocates once it grows past N, at which point it behaves like a
+    // std::vector.
+    template <typename T,
+              std::size_t N>
+    class SmallVector {
+        static_assert(N > 0, "SmallVector needs room for at least one inline value.");
+
+    public:
+        typedef T value_type;
+        typedef T* iterator;
+        typedef const T* const_iterator;
+
+    private:
+        typename std::aligned_storage<sizeof(T), alignof(T)>::type storage[N];
+        T* ptr;
+        std::size_t len;
+        std::size_t cap;
+
+        // Moving every value over to a new heap allocation with room for at
+        // least n values.
+        void grow(std::size_t);
+
+        // Destroying every value and freeing any heap allocation.
+        void release() noexcept;
+
+    public:
+        // Creating an empty SmallVector.
+        SmallVector() noexcept;
+
+        // Copying and moving SmallVectors.
+        SmallVector(const SmallVector&);
+        SmallVector(SmallVector&&);
+        SmallVector& operator=(const SmallVector&);
+        SmallVector& operator=(SmallVector&&);
+
+        // Destroying every value.
+        ~SmallVector();
+
+        // Checking whether the values are still stored inline.
+        bool isInline() const noexcept;
+
+        // Getting the number of values, and how many fit without growing.
+        std::size_t size() const noexcept;
+        std::size_t capacity() const noexcept;
+        bool empty() const noexcept;
+
+        // Accessing the values.
+        T* data() noexcept;
+        const T* data() const noexcept;
+        T& operator[](std::size_t) noexcept;
+        const T& operator[](std::size_t) const noexcept;
+        T& back() noexcept;
+        const T& back() const noexcept;
+
+        // Iterating over the values.
+        iterator begin() noexcept;
+        iterator end() noexcept;
+        const_iterator begin() const noexcept;
+        const_iterator end() const noexcept;
+
+        // Making sure there's room for at least n values.
+        void reserve(std::size_t);
+
+        // Adding a value to the end.
+        void push_back(const T&);
+        void push_back(T&&);
+
+        template <typename... Args>
+        T& emplace_back(Args&&...);
+
+        // Removing the last value.
+        void pop_back() noexcept;
+
+        // Removing every value. Any heap allocation is kept.
+        void clear() noexcept;
+    };
+
+    // Comparing the values in two SmallVectors.
+    template <typename T, std::size_t N, std::size_t M>
+    bool operator==(const SmallVector<T, N>&, const SmallVector<T, M>&);
+
+    template <typename T, std::size_t N, std::size_t M>
+    bool operator!=(const SmallVector<T, N>&, const SmallVector<T, M>&);
+}
+
+#include "smallvector.tpp"
+
+#endif
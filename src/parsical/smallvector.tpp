@@ -0,0 +1,201 @@
+#include "smallvector.hpp"
+
+// Moving every value over to a new heap allocation with room for at
+// least n values.
+template <typename T, std::size_t N>
+void parsical::SmallVector<T, N>::grow(std::size_t n) {
+    std::size_t size = std::max(n, cap * 2);
+    T* to = static_cast<T*>(::operator new(size * sizeof(T)));
+
+    for (std::size_t i = 0; i < len; i++) {
+        new (to + i) T(std::move(ptr[i]));
+        ptr[i].~T();
+    }
+
+    if (!isInline())
+        ::operator delete(ptr);
+
+    ptr = to;
+    cap = size;
+}
+
+// Destroying every value and freeing any heap allocation.
+template <typename T, std::size_t N>
+void parsical::SmallVector<T, N>::release() noexcept {
+    clear();
+    if (!isInline())
+        ::operator delete(ptr);
+
+    ptr = reinterpret_cast<T*>(storage);
+    cap = N;
+}
+
+// Creating an empty SmallVector.
+template <typename T, std::size_t N>
+parsical::SmallVector<T, N>::SmallVector() noexcept :
+        ptr(reinterpret_cast<T*>(storage)),
+        len(0),
+        cap(N) { }
+
+// Copying and moving SmallVectors.
+template <typename T, std::size_t N>
+parsical::SmallVector<T, N>::SmallVector(const parsical::SmallVector<T, N>& other) :
+        parsical::SmallVector<T, N>() {
+    reserve(other.len);
+    for (const T& value: other)
+        push_back(value);
+}
+
+template <typename T, std::size_t N>
+parsical::SmallVector<T, N>::SmallVector(parsical::SmallVector<T, N>&& other) :
+        parsical::SmallVector<T, N>() {
+    *this = std::move(other);
+}
+
+template <typename T, std::size_t N>
+parsical::SmallVector<T, N>& parsical::SmallVector<T, N>::operator=(const parsical::SmallVector<T, N>& other) {
+    if (this != &other) {
+        clear();
+        reserve(other.len);
+        for (const T& value: other)
+            push_back(value);
+    }
+
+    return *this;
+}
+
+template <typename T, std::size_t N>
+parsical::SmallVector<T, N>& parsical::SmallVector<T, N>::operator=(parsical::SmallVector<T, N>&& other) {
+    if (this == &other)
+        return *this;
+    release();
+
+    // A heap allocation can just be taken; inline values have to be moved
+    // over one at a time.
+    if (!other.isInline()) {
+        ptr = other.ptr;
+        len = other.len;
+        cap = other.cap;
+
+        other.ptr = reinterpret_cast<T*>(other.storage);
+        other.len = 0;
+        other.cap = N;
+    } else {
+        for (T& value: other)
+            push_back(std::move(value));
+        other.clear();
+    }
+
+    return *this;
+}
+
+// Destroying every value.
+template <typename T, std::size_t N>
+parsical::SmallVector<T, N>::~SmallVector() { release(); }
+
+// Checking whether the values are still stored inline.
+template <typename T, std::size_t N>
+bool parsical::SmallVector<T, N>::isInline() const noexcept {
+    return ptr == reinterpret_cast<const T*>(storage);
+}
+
+// Getting the number of values, and how many fit without growing.
+template <typename T, std::size_t N>
+std::size_t parsical::SmallVector<T, N>::size() const noexcept { return len; }
+
+template <typename T, std::size_t N>
+std::size_t parsical::SmallVector<T, N>::capacity() const noexcept { return cap; }
+
+template <typename T, std::size_t N>
+bool parsical::SmallVector<T, N>::empty() const noexcept { return len == 0; }
+
+// Accessing the values.
+template <typename T, std::size_t N>
+T* parsical::SmallVector<T, N>::data() noexcept { return ptr; }
+
+template <typename T, std::size_t N>
+const T* parsical::SmallVector<T, N>::data() const noexcept { return ptr; }
+
+template <typename T, std::size_t N>
+T& parsical::SmallVector<T, N>::operator[](std::size_t i) noexcept { return ptr[i]; }
+
+template <typename T, std::size_t N>
+const T& parsical::SmallVector<T, N>::operator[](std::size_t i) const noexcept { return ptr[i]; }
+
+template <typename T, std::size_t N>
+T& parsical::SmallVector<T, N>::back() noexcept { return ptr[len - 1]; }
+
+template <typename T, std::size_t N>
+const T& parsical::SmallVector<T, N>::back() const noexcept { return ptr[len - 1]; }
+
+// Iterating over the values.
+template <typename T, std::size_t N>
+T* parsical::SmallVector<T, N>::begin() noexcept { return ptr; }
+
+template <typename T, std::size_t N>
+T* parsical::SmallVector<T, N>::end() noexcept { return ptr + len; }
+
+template <typename T, std::size_t N>
+const T* parsical::SmallVector<T, N>::begin() const noexcept { return ptr; }
+
+template <typename T, std::size_t N>
+const T* parsical::SmallVector<T, N>::end() const noexcept { return ptr + len; }
+
+// Making sure there's room for at least n values.
+template <typename T, std::size_t N>
+void parsical::SmallVector<T, N>::reserve(std::size_t n) {
+    if (n > cap)
+        grow(n);
+}
+
+// Adding a value to the end.
+template <typename T, std::size_t N>
+void parsical::SmallVector<T, N>::push_back(const T& value) {
+    emplace_back(value);
+}
+
+template <typename T, std::size_t N>
+void parsical::SmallVector<T, N>::push_back(T&& value) {
+    emplace_back(std::move(value));
+}
+
+template <typename T, std::size_t N>
+template <typename... Args>
+T& parsical::SmallVector<T, N>::emplace_back(Args&&... args) {
+    if (len == cap) {
+        // The arguments might refer to a value that's about to be moved, so
+        // the new value gets built before growing.
+        T value(std::forward<Args>(args)...);
+        grow(len + 1);
+        new (ptr + len) T(std::move(value));
+    } else {
+        new (ptr + len) T(std::forward<Args>(args)...);
+    }
+
+    return ptr[len++];
+}
+
+// Removing the last value.
+template <typename T, std::size_t N>
+void parsical::SmallVector<T, N>::pop_back() noexcept {
+    ptr[--len].~T();
+}
+
+// Removing every value. Any heap allocation is kept.
+template <typename T, std::size_t N>
+void parsical::SmallVector<T, N>::clear() noexcept {
+    for (std::size_t i = 0; i < len; i++)
+        ptr[i].~T();
+    len = 0;
+}
+
+// Comparing the values in two SmallVectors.
+template <typename T, std::size_t N, std::size_t M>
+bool parsical::operator==(const parsical::SmallVector<T, N>& a, const parsical::SmallVector<T, M>& b) {
+    return a.size() == b.size() && std::equal(a.begin(), a.end(), b.begin());
+}
+
+template <typename T, std::size_t N, std::size_t M>
+bool parsical::operator!=(const parsical::SmallVector<T, N>& a, const parsical::SmallVector<T, M>& b) {
+    return !(a == b);
+}
@@ -0,0 +1,47 @@
+// Name: parsical/span.hpp
+//
+// Description:
+//   A non-owning view over a contiguous run of values handed out by streams
+//   that can do so without copying.
+
+#ifndef _PARSICAL_SPAN_HPP_
+#define _PARSICAL_SPAN_HPP_
+
+//////////////
+// Includes //
+#include <cstddef>
+#include <string>
+
+//////////
+// Code //
+
+namespace parsical {
+    // A pointer and a length. A Span never owns what it points to - see the
+    // function that produced it for how long it stays valid.
+    template <typename T>
+    struct Span {
+        const T* data;
+        std::size_t size;
+
+        // Constructing an empty Span.
+        Span() : data(nullptr), size(0) { }
+
+        // Constructing a Span over size values starting at data.
+        Span(const T* data, std::size_t size) : data(data), size(size) { }
+
+        // Iterating over the values in the Span.
+        const T* begin() const { return data; }
+        const T* end() const { return data + size; }
+
+        // Accessing a single value in the Span.
+        const T& operator[](std::size_t i) const { return data[i]; }
+
+        // Checking whether the Span has anything in it.
+        bool empty() const { return size == 0; }
+
+        // Copying the contents of the Span out into an owning string.
+        std::basic_string<T> str() const { return std::basic_string<T>(data, size); }
+    };
+}
+
+#endif
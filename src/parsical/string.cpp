@@ -2,8 +2,11 @@
 
 //////////////
 // Includes //
-#include <sstream>
+#include <algorithm>
 #include <cmath>
+#include <cstring>
+
+#include "grammar.hpp"
 
 //////////
 // Code //
@@ -12,9 +15,23 @@
 // consume input even if the string itself is not matched. The amount of
 // consumed input is equivalent to that of the portion of the matched
 std::string parsical::str::string(parsical::ParseStream<char>& stream, std::string str) throw(parsical::ParseError) {
+    // Comparing the whole literal at once when the stream has it buffered
+    // and there's enough input to.
+    if (stream.buffered() && stream.ensure(str.size())) {
+        parsical::Span<char> next = stream.peekN(str.size());
+        if (std::memcmp(next.data, str.data(), str.size()) == 0) {
+            stream.advance(str.size());
+            return str;
+        }
+
+        std::size_t matched = std::mismatch(str.begin(), str.end(), next.begin()).first - str.begin();
+        stream.advance(matched);
+        throw parsical::ParseError(parsical::ErrorCode::Unexpected, "Could not match string.", stream.pos());
+    }
+
     for (char c: str) {
         if (stream.peek() != c)
-            throw parsical::ParseError("Could not match string.");
+            throw parsical::ParseError(parsical::ErrorCode::Unexpected, "Could not match string.", stream.pos());
         stream.get();
     }
 
@@ -24,25 +41,40 @@ std::string parsical::str::string(parsical::ParseStream<char>& stream, std::stri
 // A version of takeWhile that returns a std::string instead of a vector
 // of characters.
 std::string parsical::str::takeWhile(parsical::ParseStream<char>& stream, std::function<bool(char)> fn) {
-    std::vector<char> chars = parsical::takeWhile(stream, fn);
-    std::ostringstream builder;
-
-    for (char c: chars)
-        builder << c;
-
-    return builder.str();
+    return parsical::str::takeWhile(stream, fn, std::allocator<char>());
 }
 
 // A version of takeUntil that returns a std::string instead of a vector
 // of characters.
 std::string parsical::str::takeUntil(parsical::ParseStream<char>& stream, std::function<bool(char)> fn) {
-    std::vector<char> chars = parsical::takeUntil(stream, fn);
-    std::ostringstream builder;
+    return parsical::str::takeUntil(stream, fn, std::allocator<char>());
+}
 
-    for (char c: chars)
-        builder << c;
+// Reading exactly n characters, e.g. for a fixed-width field. Throws
+// without consuming anything if there aren't that many left.
+std::string parsical::str::takeN(parsical::ParseStream<char>& stream, std::size_t n) throw(parsical::ParseError) {
+    if (!stream.buffered()) {
+        std::string str;
+        str.reserve(n);
+        while (str.size() < n && !stream.eof())
+            str += stream.get();
+
+        if (str.size() < n) {
+            stream.stepBack(str.size());
+            throw parsical::ParseError(parsical::ErrorCode::EndOfInput, "takeN: not enough input.", stream.pos());
+        }
+
+        return str;
+    }
+
+    if (!stream.ensure(n))
+        throw parsical::ParseError(parsical::ErrorCode::EndOfInput, "takeN: not enough input.", stream.pos());
 
-    return builder.str();
+    parsical::Span<char> field = stream.peekN(n);
+    std::string str(field.data, field.size);
+    stream.advance(n);
+
+    return str;
 }
 
 // Consuming input until either whitespace or the end of file is
@@ -50,7 +82,7 @@ std::string parsical::str::takeUntil(parsical::ParseStream<char>& stream, std::f
 std::string parsical::str::parseString(parsical::ParseStream<char>& stream) throw(parsical::ParseError) {
     std::string str = parsical::str::takeUntil(stream, isWhitespace);
     if (str == "")
-        throw parsical::ParseError("Expected some input.");
+        throw parsical::ParseError(parsical::ErrorCode::Unexpected, "Expected some input.", stream.pos());
 
     return str;
 }
@@ -64,29 +96,27 @@ void parsical::str::consumeWhitespace(parsical::ParseStream<char>& stream) {
 // Attempting to parse a bool out of a ParseStream. Does not consume any
 // input upon failure.
 bool parsical::str::parseBool(parsical::ParseStream<char>& stream) throw(parsical::ParseError) {
-    std::string str;
-
-    std::vector<std::function<std::string(parsical::ParseStream<char>&)>> fns {
-        std::bind(parsical::str::string, std::placeholders::_1, "true"),
-        std::bind(parsical::str::string, std::placeholders::_1, "false")
-    };
+    // Built once, on the first call, and shared by every call after that.
+    static const parsical::Grammar<bool> grammar = parsical::transform<bool>(
+        parsical::alternatives(std::vector<parsical::Grammar<std::string>> {
+            parsical::literal("true"),
+            parsical::literal("false")
+        }),
+        std::function<bool(std::string)>([](std::string str) -> bool { return str == "true"; })
+    );
 
     try {
-        str = parsical::option<std::string>(stream, fns);
+        return grammar(stream);
     } catch (parsical::ParseError& e) {
-        throw parsical::ParseError("Neither \"true\" nor \"false\" could be matched.");
+        throw parsical::ParseError(parsical::ErrorCode::NoMatch, "Neither \"true\" nor \"false\" could be matched.", stream.pos());
     }
-
-    if (str == "true")
-        return true;
-    return false;
 }
 
 // Attempting to parse a single digit out of a ParseStream. Does not
 // consume any input upon failure.
 int parsical::str::parseDigit(parsical::ParseStream<char>& stream) throw(parsical::ParseError) {
     if (!parsical::str::isNumber(stream.peek()))
-        throw parsical::ParseError("");
+        throw parsical::ParseError(parsical::ErrorCode::Unexpected, "Expected a digit.", stream.pos());
 
     return (int)(stream.get() - '0');
 }
@@ -102,7 +132,7 @@ int parsical::str::parseInt(parsical::ParseStream<char>& stream) throw(parsical:
         }
 
         if (!parsical::str::isNumber(stream.peek()))
-            throw parsical::ParseError("Expected a number.");
+            throw parsical::ParseError(parsical::ErrorCode::Unexpected, "Expected a number.", stream.pos());
 
         int sum = 0;
         while (true) {
@@ -129,7 +159,7 @@ float parsical::str::parseFloat(ParseStream<char>& stream) throw(parsical::Parse
 
         std::vector<char> number = parsical::takeWhile(stream, isNumber);
         if (number.size() == 0)
-            throw parsical::ParseError("Expected the first half of a float.");
+            throw parsical::ParseError(parsical::ErrorCode::Unexpected, "Expected the first half of a float.", stream.pos());
 
         std::vector<char> decimal;
         bool dec = false;
@@ -142,7 +172,7 @@ float parsical::str::parseFloat(ParseStream<char>& stream) throw(parsical::Parse
         if (!stream.eof() && stream.peek() == 'f')
             stream.get();
         else if (dec && decimal.size() == 0)
-            throw parsical::ParseError("Expected the second half of a float.");
+            throw parsical::ParseError(parsical::ErrorCode::Unexpected, "Expected the second half of a float.", stream.pos());
 
         float nAccum = 0.f;
         for (char c: number) {
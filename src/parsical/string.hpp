@@ -31,10 +31,22 @@ namespace parsical {
         // of characters.
         std::string takeWhile(ParseStream<char>&, std::function<bool(char)>);
 
+        // An allocator-aware version of str::takeWhile.
+        template <typename Allocator>
+        std::basic_string<char, std::char_traits<char>, Allocator> takeWhile(ParseStream<char>&, std::function<bool(char)>, const Allocator&);
+
         // A version of takeUntil that returns a std::string instead of a vector
         // of characters.
         std::string takeUntil(ParseStream<char>&, std::function<bool(char)>);
 
+        // An allocator-aware version of str::takeUntil.
+        template <typename Allocator>
+        std::basic_string<char, std::char_traits<char>, Allocator> takeUntil(ParseStream<char>&, std::function<bool(char)>, const Allocator&);
+
+        // Reading exactly n characters, e.g. for a fixed-width field. Throws
+        // without consuming anything if there aren't that many left.
+        std::string takeN(ParseStream<char>&, std::size_t) throw(ParseError);
+
         // Consuming input until either whitespace or the end of file is
         // reached. Throws an error if nothing is consumed.
         std::string parseString(ParseStream<char>&) throw(ParseError);
@@ -69,4 +81,6 @@ namespace parsical {
     }
 }
 
+#include "string.tpp"
+
 #endif
@@ -0,0 +1,23 @@
+#include "string.hpp"
+
+// An allocator-aware version of str::takeWhile.
+template <typename Allocator>
+std::basic_string<char, std::char_traits<char>, Allocator> parsical::str::takeWhile(parsical::ParseStream<char>& stream, std::function<bool(char)> fn, const Allocator& alloc) {
+    std::basic_string<char, std::char_traits<char>, Allocator> str(alloc);
+
+    while (!stream.eof() && fn(stream.peek()))
+        str.push_back(stream.get());
+
+    return str;
+}
+
+// An allocator-aware version of str::takeUntil.
+template <typename Allocator>
+std::basic_string<char, std::char_traits<char>, Allocator> parsical::str::takeUntil(parsical::ParseStream<char>& stream, std::function<bool(char)> fn, const Allocator& alloc) {
+    std::basic_string<char, std::char_traits<char>, Allocator> str(alloc);
+
+    while (!stream.eof() && !fn(stream.peek()))
+        str.push_back(stream.get());
+
+    return str;
+}
@@ -0,0 +1,143 @@
+#include "symbols.hpp"
+
+//////////////
+// Includes //
+#include <cstring>
+
+#include "smallvector.hpp"
+#include "string.hpp"
+
+//////////
+// Code //
+
+// Symbols compare by id alone.
+bool parsical::operator==(const parsical::Symbol& a, const parsical::Symbol& b) noexcept {
+    return a.id == b.id;
+}
+
+bool parsical::operator!=(const parsical::Symbol& a, const parsical::Symbol& b) noexcept {
+    return a.id != b.id;
+}
+
+// Hashing a run of characters.
+std::uint32_t parsical::SymbolTable::hash(const char* data, std::size_t size) noexcept {
+    // FNV-1a.
+    std::uint32_t h = 2166136261u;
+    for (std::size_t i = 0; i < size; i++) {
+        h ^= static_cast<unsigned char>(data[i]);
+        h *= 16777619u;
+    }
+    return h;
+}
+
+// Doubling the number of slots and reinserting every name.
+void parsical::SymbolTable::grow() {
+    std::vector<Slot> old(slots.size() * 2, Slot { nullptr, 0, 0, 0 });
+    old.swap(slots);
+
+    std::size_t mask = slots.size() - 1;
+    for (const Slot& s: old) {
+        if (s.data == nullptr)
+            continue;
+
+        std::size_t i = s.hash & mask;
+        while (slots[i].data != nullptr)
+            i = (i + 1) & mask;
+        slots[i] = s;
+    }
+}
+
+// Interning without taking the lock.
+parsical::Symbol parsical::SymbolTable::internUnlocked(const char* data, std::size_t size) {
+    std::uint32_t h = hash(data, size);
+    std::size_t mask = slots.size() - 1;
+
+    std::size_t i = h & mask;
+    while (slots[i].data != nullptr) {
+        const Slot& s = slots[i];
+        if (s.hash == h && s.size == size && std::memcmp(s.data, data, size) == 0)
+            return Symbol { s.id, names[s.id] };
+        i = (i + 1) & mask;
+    }
+
+    // Keeping the load factor at or below a half, so probes stay short.
+    if ((names.size() + 1) * 2 > slots.size()) {
+        grow();
+        mask = slots.size() - 1;
+        i = h & mask;
+        while (slots[i].data != nullptr)
+            i = (i + 1) & mask;
+    }
+
+    // The empty name still needs a non-null pointer to mark its slot used.
+    const char* stored = size == 0 ? static_cast<const char*>(arena.allocate(1, 1))
+                                   : arena.copy(data, size);
+    std::uint32_t id = static_cast<std::uint32_t>(names.size());
+
+    slots[i] = Slot { stored, static_cast<std::uint32_t>(size), h, id };
+    names.push_back(Span<char>(stored, size));
+
+    return Symbol { id, names.back() };
+}
+
+// Creating a SymbolTable with room for the given number of names
+// before it has to grow.
+parsical::SymbolTable::SymbolTable(std::size_t expected, bool concurrent) :
+        concurrent(concurrent) {
+    std::size_t capacity = 16;
+    while (capacity < expected * 2)
+        capacity *= 2;
+
+    slots.assign(capacity, Slot { nullptr, 0, 0, 0 });
+    names.reserve(expected);
+}
+
+// Finding the Symbol for a name, adding it if it's new.
+parsical::Symbol parsical::SymbolTable::intern(const char* data, std::size_t size) {
+    if (!concurrent)
+        return internUnlocked(data, size);
+
+    std::lock_guard<std::mutex> guard(lock);
+    return internUnlocked(data, size);
+}
+
+parsical::Symbol parsical::SymbolTable::intern(const std::string& str) {
+    return intern(str.data(), str.size());
+}
+
+// Finding the name for a previously returned id.
+parsical::Span<char> parsical::SymbolTable::name(std::uint32_t id) const {
+    if (!concurrent)
+        return names.at(id);
+
+    std::lock_guard<std::mutex> guard(lock);
+    return names.at(id);
+}
+
+// The number of distinct names in the table.
+std::size_t parsical::SymbolTable::size() const {
+    if (!concurrent)
+        return names.size();
+
+    std::lock_guard<std::mutex> guard(lock);
+    return names.size();
+}
+
+// Whether the table can be shared between threads.
+bool parsical::SymbolTable::isConcurrent() const noexcept {
+    return concurrent;
+}
+
+// Parsing an identifier - a run of alphanumeric characters - and
+// interning it, without building a std::string along the way. Throws
+// if there's no identifier at the current position.
+parsical::Symbol parsical::str::internedIdentifier(parsical::ParseStream<char>& stream, parsical::SymbolTable& table) throw(parsical::ParseError) {
+    parsical::SmallVector<char, 64> scratch;
+    while (!stream.eof() && parsical::str::isAlphaNum(stream.peek()))
+        scratch.push_back(stream.get());
+
+    if (scratch.empty())
+        throw parsical::ParseError(parsical::ErrorCode::Unexpected, "internedIdentifier: no identifier.", stream.pos());
+
+    return table.intern(scratch.data(), scratch.size());
+}
@@ -0,0 +1,101 @@
+// Name: parsical/symbols.hpp
+//
+// Description:
+//   An interning table for names that come up over and over again in a
+//   document, so each distinct name is stored once and can be compared by id.
+
+#ifndef _PARSICAL_SYMBOLS_HPP_
+#define _PARSICAL_SYMBOLS_HPP_
+
+//////////////
+// Includes //
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "arena.hpp"
+#include "parsestream.hpp"
+#include "parseerror.hpp"
+#include "span.hpp"
+
+//////////
+// Code //
+
+namespace parsical {
+    // An interned name. Two Symbols from the same SymbolTable are the same
+    // name exactly when their ids are equal. The view points into the table,
+    // and stays valid for as long as the table does.
+    struct Symbol {
+        std::uint32_t id;
+        Span<char> view;
+    };
+
+    // Symbols compare by id alone.
+    bool operator==(const Symbol&, const Symbol&) noexcept;
+    bool operator!=(const Symbol&, const Symbol&) noexcept;
+
+    // A hash set of names using open addressing with linear probing. The
+    // characters of each name are copied into an arena once, and every later
+    // lookup of the same name hands back the same id and view. Ids are given
+    // out densely from 0 in the order names are first seen.
+    //
+    // A SymbolTable made concurrent can be shared between threads; every
+    // operation then takes a lock. Otherwise it's not thread-safe.
+    class SymbolTable {
+    private:
+        // A slot in the hash table. An empty slot has a null data pointer.
+        struct Slot {
+            const char* data;
+            std::uint32_t size;
+            std::uint32_t hash;
+            std::uint32_t id;
+        };
+
+        ParseArena arena;
+        std::vector<Slot> slots;
+        std::vector<Span<char>> names;
+        bool concurrent;
+        mutable std::mutex lock;
+
+        // Hashing a run of characters.
+        static std::uint32_t hash(const char*, std::size_t) noexcept;
+
+        // Doubling the number of slots and reinserting every name.
+        void grow();
+
+        // Interning without taking the lock.
+        Symbol internUnlocked(const char*, std::size_t);
+
+    public:
+        // Creating a SymbolTable with room for the given number of names
+        // before it has to grow.
+        SymbolTable(std::size_t expected = 1024, bool concurrent = false);
+
+        SymbolTable(const SymbolTable&) = delete;
+        SymbolTable& operator=(const SymbolTable&) = delete;
+
+        // Finding the Symbol for a name, adding it if it's new.
+        Symbol intern(const char*, std::size_t);
+        Symbol intern(const std::string&);
+
+        // Finding the name for a previously returned id.
+        Span<char> name(std::uint32_t) const;
+
+        // The number of distinct names in the table.
+        std::size_t size() const;
+
+        // Whether the table can be shared between threads.
+        bool isConcurrent() const noexcept;
+    };
+
+    namespace str {
+        // Parsing an identifier - a run of alphanumeric characters - and
+        // interning it, without building a std::string along the way. Throws
+        // if there's no identifier at the current position.
+        Symbol internedIdentifier(ParseStream<char>&, SymbolTable&) throw(ParseError);
+    }
+}
+
+#endif
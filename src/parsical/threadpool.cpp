@@ -0,0 +1,146 @@
+#include "threadpool.hpp"
+
+//////////////
+// Includes //
+#include <algorithm>
+#include <exception>
+
+//////////
+// Code //
+
+// Everything needed to keep track of a single call to run.
+struct parsical::ThreadPool::Job {
+    std::function<void(std::size_t, std::size_t)> fn;
+    std::vector<std::exception_ptr> errors;
+    std::size_t remaining;
+    std::mutex mutex;
+    std::condition_variable done;
+};
+
+// Taking a task from the back of the worker's own queue, or else
+// stealing one from the front of someone else's.
+bool parsical::ThreadPool::take(std::size_t self, parsical::ThreadPool::Task& task) noexcept {
+    {
+        Worker& own = *workers[self];
+        std::lock_guard<std::mutex> lock(own.mutex);
+        if (!own.tasks.empty()) {
+            task = own.tasks.back();
+            own.tasks.pop_back();
+            return true;
+        }
+    }
+
+    for (std::size_t i = 1; i < workers.size(); i++) {
+        Worker& victim = *workers[(self + i) % workers.size()];
+        std::lock_guard<std::mutex> lock(victim.mutex);
+        if (!victim.tasks.empty()) {
+            task = victim.tasks.front();
+            victim.tasks.pop_front();
+            return true;
+        }
+    }
+
+    return false;
+}
+
+// The worker threads' loop.
+void parsical::ThreadPool::work(std::size_t self) noexcept {
+    while (true) {
+        Task task;
+        if (!take(self, task)) {
+            std::unique_lock<std::mutex> lock(mutex);
+            wake.wait(lock, [this]() { return stopping || pending.load() > 0; });
+            if (stopping && pending.load() == 0)
+                return;
+            continue;
+        }
+        pending--;
+
+        Job& job = *task.job;
+        try {
+            job.fn(self, task.index);
+        } catch (...) {
+            job.errors[task.index] = std::current_exception();
+        }
+
+        // The job lives on run's stack, and run may return as soon as it
+        // sees remaining hit 0 - so that has to happen under the lock, and
+        // this is the last time the job is touched.
+        std::lock_guard<std::mutex> lock(job.mutex);
+        if (--job.remaining == 0)
+            job.done.notify_all();
+    }
+}
+
+// Creating a ThreadPool with the given number of workers. 0 means one
+// per hardware thread.
+parsical::ThreadPool::ThreadPool(std::size_t threads) :
+        pending(0),
+        stopping(false) {
+    if (threads == 0)
+        threads = std::max(1u, std::thread::hardware_concurrency());
+
+    for (std::size_t i = 0; i < threads; i++)
+        workers.push_back(std::unique_ptr<Worker>(new Worker()));
+    for (std::size_t i = 0; i < threads; i++)
+        workers[i]->thread = std::thread(&parsical::ThreadPool::work, this, i);
+}
+
+// Finishing the work that's been handed out, and joining every worker.
+parsical::ThreadPool::~ThreadPool() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    wake.notify_all();
+
+    for (std::unique_ptr<Worker>& worker: workers)
+        worker->thread.join();
+}
+
+// The number of workers.
+std::size_t parsical::ThreadPool::size() const noexcept { return workers.size(); }
+
+// Calling fn(worker, index) for every index in [0, count) across the
+// workers, and waiting for all of them to finish. If any call throws,
+// the first exception (by index) is rethrown once everything is done.
+void parsical::ThreadPool::run(std::size_t count, std::function<void(std::size_t, std::size_t)> fn) {
+    if (count == 0)
+        return;
+
+    Job job;
+    job.fn = fn;
+    job.errors.resize(count);
+    job.remaining = count;
+
+    // Dealing out contiguous runs of indices, so neighbouring work tends to
+    // stay on the same worker unless it gets stolen.
+    for (std::size_t w = 0; w < workers.size(); w++) {
+        std::size_t from = count * w / workers.size();
+        std::size_t to = count * (w + 1) / workers.size();
+
+        std::lock_guard<std::mutex> lock(workers[w]->mutex);
+        for (std::size_t i = to; i > from; i--)
+            workers[w]->tasks.push_back({ &job, i - 1 });
+    }
+
+    // Counting the tasks only once they're queued, so that a woken worker
+    // always finds one. A worker that's already awake may take one first and
+    // briefly wrap pending below zero; it's only a hint, and the job's own
+    // remaining count is what run waits on.
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        pending += count;
+    }
+
+    wake.notify_all();
+
+    {
+        std::unique_lock<std::mutex> lock(job.mutex);
+        job.done.wait(lock, [&job]() { return job.remaining == 0; });
+    }
+
+    for (std::exception_ptr& error: job.errors)
+        if (error)
+            std::rethrow_exception(error);
+}
@@ -0,0 +1,78 @@
+// Name: parsical/threadpool.hpp
+//
+// Description:
+//   A small work-stealing thread pool used to run parses in parallel.
+
+#ifndef _PARSICAL_THREAD_POOL_HPP_
+#define _PARSICAL_THREAD_POOL_HPP_
+
+//////////////
+// Includes //
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "executor.hpp"
+
+//////////
+// Code //
+
+namespace parsical {
+    // A pool of worker threads, each with its own queue of work. Work is
+    // handed out evenly up front, and a worker that runs out steals from the
+    // front of another worker's queue.
+    class ThreadPool : public Executor {
+    private:
+        struct Job;
+
+        // A single index of a single job.
+        struct Task {
+            Job* job;
+            std::size_t index;
+        };
+
+        // A worker and its queue.
+        struct Worker {
+            std::mutex mutex;
+            std::deque<Task> tasks;
+            std::thread thread;
+        };
+
+        std::vector<std::unique_ptr<Worker>> workers;
+        std::mutex mutex;
+        std::condition_variable wake;
+        std::atomic<std::size_t> pending;
+        bool stopping;
+
+        // Taking a task from the back of the worker's own queue, or else
+        // stealing one from the front of someone else's.
+        bool take(std::size_t, Task&) noexcept;
+
+        // The worker threads' loop.
+        void work(std::size_t) noexcept;
+
+    public:
+        // Creating a ThreadPool with the given number of workers. 0 means one
+        // per hardware thread.
+        ThreadPool(std::size_t threads = 0);
+
+        // Finishing the work that's been handed out, and joining every worker.
+        ~ThreadPool();
+
+        // The number of workers.
+        virtual std::size_t size() const noexcept override;
+
+        // Calling fn(worker, index) for every index in [0, count) across the
+        // workers, and waiting for all of them to finish. If any call throws,
+        // the first exception (by index) is rethrown once everything is done.
+        virtual void run(std::size_t, std::function<void(std::size_t, std::size_t)>) override;
+    };
+}
+
+#endif
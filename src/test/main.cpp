@@ -1,7 +1,17 @@
 //////////////
 // Includes //
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <ctime>
+#include <forward_list>
+#include <fstream>
 #include <functional>
 #include <iostream>
+#include <list>
+#include <sstream>
+#include <thread>
+#include <deque>
 
 #include "catch.hpp"
 
@@ -10,6 +20,11 @@
 //////////
 // Code //
 
+// Getting a path for a scratch file used by a test.
+std::string tempPath(std::string name) {
+    return "/tmp/parsical-test-" + name;
+}
+
 ////
 // parsestream.hpp
 
@@ -42,6 +57,29 @@ void testParser(parsical::ParseStream<T>& p, std::vector<T> values) {
     // the internal state of the parser.
     REQUIRE(p.peek() == values.at(0));
     REQUIRE(p.peek() == values.at(0));
+
+    // The bulk operations should agree with get, and leave the stream where
+    // they found it when they fail.
+    REQUIRE(p.ensure(values.size()));
+    REQUIRE(!p.ensure(values.size() + 1));
+    REQUIRE(p.pos() == 0);
+
+    std::size_t n = std::min<std::size_t>(values.size(), 3);
+    parsical::Span<T> ahead = p.peekN(n);
+    REQUIRE(std::vector<T>(ahead.begin(), ahead.end()) == std::vector<T>(values.begin(), values.begin() + n));
+    REQUIRE_THROWS(p.peekN(values.size() + 1));
+    REQUIRE(p.pos() == 0);
+
+    p.advance(n - 1);
+    REQUIRE(p.getUnchecked() == values.at(n - 1));
+    REQUIRE(p.pos() == n);
+    p.stepBack(n);
+
+    // Seeking forwards and back again.
+    p.seek(n - 1);
+    REQUIRE(p.get() == values.at(n - 1));
+    p.seek(0);
+    REQUIRE(p.peek() == values.at(0));
 }
 
 // Testing out the string parser for a couple of functions.
@@ -52,6 +90,253 @@ TEST_CASE("StringParser") {
     testParser(p, values);
 }
 
+// A stream with no buffer of its own, which counts how it's used.
+struct CountingStream : public parsical::ParseStream<char> {
+    parsical::StringParser inner;
+    int gets = 0;
+    int stepBacks = 0;
+
+    CountingStream(std::string str) : inner(str) { }
+
+    virtual bool eof() const noexcept override { return inner.eof(); }
+    virtual char peek() const throw(parsical::ParseError) override { return inner.peek(); }
+    virtual std::size_t pos() const noexcept override { return inner.pos(); }
+
+    virtual char get() throw(parsical::ParseError) override {
+        gets++;
+        return inner.get();
+    }
+
+    virtual void stepBack(std::size_t n) throw(parsical::ParseError) override {
+        stepBacks++;
+        inner.stepBack(n);
+    }
+};
+
+// A stream whose input goes bad part way through, like a truncated file.
+struct BrokenStream : public parsical::ParseStream<char> {
+    parsical::StringParser inner;
+    std::size_t breaksAt;
+    mutable bool broken = false;
+
+    BrokenStream(std::string str, std::size_t breaksAt) : inner(str), breaksAt(breaksAt) { }
+
+    void check() const {
+        if (inner.pos() >= breaksAt) {
+            broken = true;
+            throw parsical::ParseError(parsical::ErrorCode::Generic, "The input is corrupt.", inner.pos());
+        }
+    }
+
+    virtual bool eof() const noexcept override { return inner.pos() < breaksAt && inner.eof(); }
+    virtual std::size_t pos() const noexcept override { return inner.pos(); }
+    virtual bool failed() const noexcept override { return broken; }
+
+    virtual char peek() const throw(parsical::ParseError) override {
+        check();
+        return inner.peek();
+    }
+
+    virtual char get() throw(parsical::ParseError) override {
+        check();
+        return inner.get();
+    }
+
+    virtual void stepBack(std::size_t n) throw(parsical::ParseError) override { inner.stepBack(n); }
+};
+
+// A streambuf that hands out some of its input and then fails to read
+// the rest, like a disk going bad.
+struct BrokenBuf : public std::streambuf {
+    std::string good;
+    bool served = false;
+
+    BrokenBuf(std::string str, std::size_t breaksAt) : good(str.substr(0, breaksAt)) { }
+
+    virtual int_type underflow() override {
+        if (served)
+            throw std::runtime_error("Could not read.");
+
+        served = true;
+        setg(&good[0], &good[0], &good[0] + good.size());
+        return traits_type::to_int_type(good[0]);
+    }
+};
+
+// Parsing a single letter.
+static char letter(parsical::ParseStream<char>& s) {
+    if (!parsical::str::isAlpha(s.peek()))
+        throw parsical::ParseError(parsical::ErrorCode::Unexpected, "Expected a letter.", s.pos());
+    return s.get();
+}
+
+// Testing that literals are matched in one go where possible, while still
+// consuming the matched prefix of a failed match, and that fixed-width
+// fields can be read in one call.
+TEST_CASE("Bulk lookahead") {
+    parsical::StringParser p("header:1234abcd");
+    REQUIRE(parsical::str::string(p, "header:") == "header:");
+    REQUIRE(parsical::str::takeN(p, 4) == "1234");
+    REQUIRE_THROWS_AS(parsical::str::takeN(p, 5), parsical::ParseError&);
+    REQUIRE(p.pos() == 11);
+
+    REQUIRE_THROWS(parsical::str::string(p, "abxd"));
+    REQUIRE(p.pos() == 13);
+
+    parsical::StringParser q("ab");
+    REQUIRE_THROWS(parsical::str::string(q, "abc"));
+    REQUIRE(q.pos() == 2);
+
+    std::deque<char> chars { 'x', 'y', 'z' };
+    auto r = parsical::makeIteratorParser(chars.begin(), chars.end());
+    REQUIRE(parsical::str::string(r, "xy") == "xy");
+    REQUIRE(parsical::str::takeN(r, 1) == "z");
+
+    // IStreamParser reads into its buffer as it goes.
+    std::istringstream in("key=1234");
+    parsical::IStreamParser s(in);
+    REQUIRE(parsical::str::string(s, "key=") == "key=");
+    REQUIRE_THROWS_AS(parsical::str::takeN(s, 5), parsical::ParseError&);
+    REQUIRE(s.pos() == 4);
+    REQUIRE(parsical::str::takeN(s, 2) == "12");
+    REQUIRE_THROWS(parsical::str::string(s, "3x"));
+    REQUIRE(s.pos() == 7);
+
+    // Streams without a buffer of their own are matched a value at a time.
+    CountingStream counted("abcdef");
+    REQUIRE(parsical::str::string(counted, "abc") == "abc");
+    REQUIRE(counted.gets == 3);
+    REQUIRE(counted.stepBacks == 0);
+}
+
+// Testing that forks move independently of the stream they came from, and
+// can parse disjoint parts of the same input on other threads.
+TEST_CASE("fork") {
+    parsical::StringParser p("12 34 56 78");
+    std::unique_ptr<parsical::ParseStream<char>> f = p.fork();
+    REQUIRE(f);
+    REQUIRE(parsical::str::parseInt(*f) == 12);
+    REQUIRE(f->pos() == 2);
+    REQUIRE(p.pos() == 0);
+
+    std::vector<int> values(4);
+    std::vector<std::thread> threads;
+    for (int i = 0; i < 4; i++) {
+        std::shared_ptr<parsical::ParseStream<char>> cursor(p.fork());
+        cursor->advance(i * 3);
+        threads.push_back(std::thread([cursor, &values, i]() {
+            values[i] = parsical::str::parseInt(*cursor);
+        }));
+    }
+    for (std::thread& t: threads)
+        t.join();
+    REQUIRE(values == (std::vector<int> { 12, 34, 56, 78 }));
+
+    const char* text = "abc";
+    parsical::IteratorParser<const char*> q(text, text + 3, 10);
+    q.get();
+    std::unique_ptr<parsical::ParseStream<char>> g = q.fork();
+    REQUIRE(g->get() == 'b');
+    REQUIRE(g->pos() == 12);
+    REQUIRE(q.pos() == 11);
+
+    std::istringstream in("abcdef");
+    parsical::IStreamParser r(in);
+    r.get();
+    std::unique_ptr<parsical::ParseStream<char>> h = r.fork();
+    REQUIRE(h->get() == 'b');
+    REQUIRE(h->get() == 'c');
+    REQUIRE(r.get() == 'b');
+    h->stepBack(2);
+    REQUIRE(h->get() == 'b');
+    REQUIRE_THROWS_AS(r.seek(10), parsical::ParseError&);
+    r.seek(5);
+    REQUIRE(r.get() == 'f');
+}
+
+// Testing that an IStreamParser's buffer holds on to whatever its forks
+// still need, even while the parser it came from is forgetting as it goes.
+TEST_CASE("fork (IStreamParser)") {
+    std::string text(100000, 'x');
+    text[10] = 'y';
+    std::istringstream in(text);
+    parsical::IStreamParser p(in);
+    p.setHistory(0);
+
+    p.advance(10);
+    std::unique_ptr<parsical::ParseStream<char>> f = p.fork();
+    p.advance(50000);
+    REQUIRE_THROWS_AS(p.stepBack(1), parsical::ParseError&);
+    REQUIRE(f->get() == 'y');
+    REQUIRE(f->pos() == 11);
+
+    f.reset();
+    parsical::str::takeWhile(p, [](char c) { return c == 'x'; });
+    REQUIRE(p.eof());
+    REQUIRE(p.pos() == 100000);
+}
+
+// Testing that forks of the buffered streams see the same input, and that
+// their position is kept while they're alive.
+TEST_CASE("fork (buffered)") {
+    parsical::FeedParser feed;
+    feed.feed("12 34");
+    parsical::str::parseInt(feed);
+    std::unique_ptr<parsical::ParseStream<char>> f = feed.fork();
+    feed.get();
+    feed.discardConsumed();
+    feed.feed(" 56");
+    REQUIRE(f->get() == ' ');
+    REQUIRE(parsical::str::parseInt(*f) == 34);
+    REQUIRE(f->get() == ' ');
+    REQUIRE(parsical::str::parseInt(*f) == 56);
+    REQUIRE(f->pos() == 8);
+    REQUIRE(feed.pos() == 3);
+    f->stepBack(6);
+    REQUIRE(f->get() == ' ');
+    REQUIRE_THROWS_AS(f->peekN(10), parsical::NeedMoreInput&);
+    REQUIRE(feed.starved());
+
+    parsical::RingBuffer ring(16);
+    parsical::RingParser r(ring, 4);
+    ring.writeAll("abcdefghij", 10);
+    ring.close();
+    r.get();
+    std::unique_ptr<parsical::ParseStream<char>> g = r.fork();
+    r.advance(8);
+    r.discardBefore(9);
+    REQUIRE_THROWS_AS(r.stepBack(1), parsical::ParseError&);
+    REQUIRE(g->get() == 'b');
+    g->stepBack(1);
+    REQUIRE(parsical::str::string(*g, "bcdefghij") == "bcdefghij");
+    REQUIRE(g->eof());
+    REQUIRE(r.get() == 'j');
+}
+
+// Testing that seeking forgets the last cut, so that a failed parse after
+// seeking back to before it still rewinds.
+TEST_CASE("seek (cut)") {
+    auto failing = [](parsical::ParseStream<char>& s) -> char {
+        s.get();
+        s.get();
+        throw parsical::ParseError(parsical::ErrorCode::Unexpected, "Failing on purpose.", s.pos());
+    };
+
+    std::istringstream in("abcdef");
+    parsical::IStreamParser p(in);
+    parsical::StringParser q("abcdef");
+    std::vector<parsical::ParseStream<char>*> streams { &p, &q };
+    for (parsical::ParseStream<char>* s: streams) {
+        parsical::str::string(*s, "abcd");
+        s->cut();
+        s->seek(1);
+        REQUIRE(s->lastCut() == 0);
+        REQUIRE_THROWS_AS(parsical::tryParse<char>(*s, failing), parsical::ParseError&);
+        REQUIRE(s->pos() == 1);
+        REQUIRE(s->get() == 'b');
+    }
+}
+
 // Testing out a file parser in a similar way.
 TEST_CASE("FileParser") {
     parsical::IStreamParser p("res/testfile.txt");
@@ -60,6 +345,1348 @@ TEST_CASE("FileParser") {
     testParser(p, values);
 }
 
+// Testing that a limited history keeps only the most recent characters,
+// and that a forward-only IStreamParser refuses to step back at all.
+TEST_CASE("IStreamParser (history)") {
+    std::istringstream in("abcdefgh");
+    parsical::IStreamParser p(in);
+    REQUIRE(p.getHistory() == parsical::IStreamParser::unlimited);
+
+    p.setHistory(3);
+    for (int i = 0; i < 6; i++)
+        p.get();
+    REQUIRE_THROWS_AS(p.stepBack(4), parsical::ParseError&);
+    p.stepBack(3);
+    REQUIRE(p.get() == 'd');
+
+    p.setHistory(0);
+    REQUIRE_THROWS_AS(p.stepBack(1), parsical::ParseError&);
+    REQUIRE_THROWS_AS(p.unget(), parsical::ParseError&);
+    REQUIRE(p.get() == 'e');
+
+    std::ostringstream builder;
+    for (int i = 0; i < 10000; i++)
+        builder << i << ' ';
+    std::istringstream numbers(builder.str());
+
+    parsical::IStreamParser q(numbers);
+    q.setHistory(0);
+    std::vector<int> values = parsical::many<int>(q, [](parsical::ParseStream<char>& stream) -> int {
+        int n = parsical::str::parseInt(stream);
+        parsical::str::consumeWhitespace(stream);
+        return n;
+    });
+
+    REQUIRE(q.eof());
+    REQUIRE(values.size() == 10000);
+    REQUIRE(values.back() == 9999);
+}
+
+// Testing that looking ahead on a forward-only IStreamParser doesn't count
+// against its history, so that literals still match.
+TEST_CASE("IStreamParser (forward-only lookahead)") {
+    for (std::size_t history: std::vector<std::size_t> { 0, 2 }) {
+        std::istringstream in("key=1\n");
+        parsical::IStreamParser p(in);
+        p.setHistory(history);
+
+        REQUIRE(parsical::str::string(p, "key=") == "key=");
+        REQUIRE(parsical::str::parseInt(p) == 1);
+        REQUIRE_THROWS_AS(parsical::str::string(p, "x\n"), parsical::ParseError&);
+        REQUIRE(p.pos() == 5);
+        REQUIRE(parsical::str::string(p, "\n") == "\n");
+        REQUIRE(p.eof());
+    }
+
+    std::istringstream in("abcdefgh");
+    parsical::IStreamParser p(in);
+    p.setHistory(0);
+    p.get();
+    REQUIRE(p.ensure(7));
+    REQUIRE(!p.ensure(8));
+    parsical::Span<char> ahead = p.peekN(7);
+    REQUIRE(std::string(ahead.begin(), ahead.end()) == "bcdefgh");
+    p.advance(3);
+    REQUIRE(p.getUnchecked() == 'e');
+    REQUIRE_THROWS_AS(p.stepBack(1), parsical::ParseError&);
+}
+
+////
+// arena.hpp
+
+// Something that counts how many times it's been destroyed.
+struct Counted {
+    int* count;
+    Counted(int* count) : count(count) { }
+    ~Counted() { (*count)++; }
+};
+
+// Testing the ParseArena's allocation and reset.
+TEST_CASE("ParseArena") {
+    parsical::ParseArena arena(256);
+
+    for (int round = 0; round < 3; round++) {
+        for (int i = 0; i < 100; i++) {
+            double* d = arena.make<double>(i);
+            REQUIRE((reinterpret_cast<std::uintptr_t>(d) % alignof(double)) == 0);
+            REQUIRE(*d == i);
+        }
+        REQUIRE(arena.bytesUsed() >= 100 * sizeof(double));
+
+        // Chunks are recycled, so the arena doesn't keep growing.
+        std::size_t reserved = arena.bytesReserved();
+        arena.reset();
+        REQUIRE(arena.bytesUsed() == 0);
+        REQUIRE(arena.bytesReserved() == reserved);
+    }
+
+    // Big allocations get a chunk of their own, which is dropped on reset.
+    std::size_t reserved = arena.bytesReserved();
+    arena.allocate(4096);
+    REQUIRE(arena.bytesReserved() > reserved);
+    arena.reset();
+    REQUIRE(arena.bytesReserved() == reserved);
+
+    // Destructors are run on reset.
+    int destroyed = 0;
+    arena.make<Counted>(&destroyed);
+    arena.make<Counted>(&destroyed);
+    REQUIRE(destroyed == 0);
+    arena.reset();
+    REQUIRE(destroyed == 2);
+
+    REQUIRE(std::string(arena.copy("hello", 5), 5) == "hello");
+}
+
+// Testing standard containers on top of a ParseArena.
+TEST_CASE("ArenaAllocator") {
+    parsical::ParseArena arena;
+    parsical::ArenaAllocator<int> alloc(arena);
+
+    std::vector<int, parsical::ArenaAllocator<int>> values(alloc);
+    for (int i = 0; i < 1000; i++)
+        values.push_back(i);
+
+    REQUIRE(values.size() == 1000);
+    REQUIRE(values[999] == 999);
+    REQUIRE(arena.bytesUsed() >= 1000 * sizeof(int));
+    REQUIRE(parsical::ArenaAllocator<char>(alloc) == alloc);
+}
+
+// Testing the allocator-aware combinators on top of a ParseArena.
+TEST_CASE("allocator-aware combinators") {
+    parsical::ParseArena arena;
+    parsical::StringParser p("aaab 1 2 3 x");
+
+    std::vector<char, parsical::ArenaAllocator<char>> as = parsical::takeWhile(p, [](char c) -> bool { return c == 'a'; }, parsical::ArenaAllocator<char>(arena));
+    REQUIRE(as.size() == 3);
+    REQUIRE(as.get_allocator().arena == &arena);
+
+    std::vector<char, parsical::ArenaAllocator<char>> b = parsical::takeUntil(p, parsical::str::isWhitespace, parsical::ArenaAllocator<char>(arena));
+    REQUIRE(b.size() == 1);
+    REQUIRE(b[0] == 'b');
+
+    auto number = [](parsical::ParseStream<char>& stream) -> int {
+        parsical::str::consumeWhitespace(stream);
+        return parsical::str::parseInt(stream);
+    };
+    std::vector<int, parsical::ArenaAllocator<int>> numbers = parsical::many<int>(p, number, parsical::ArenaAllocator<int>(arena));
+    REQUIRE(numbers.size() == 3);
+    REQUIRE(numbers[2] == 3);
+    REQUIRE_THROWS(parsical::manyOne<int>(p, number, parsical::ArenaAllocator<int>(arena)));
+
+    parsical::str::consumeWhitespace(p);
+    std::basic_string<char, std::char_traits<char>, parsical::ArenaAllocator<char>> x = parsical::str::takeWhile(p, parsical::str::isAlpha, parsical::ArenaAllocator<char>(arena));
+    REQUIRE(x == "x");
+    REQUIRE(arena.bytesUsed() > 0);
+}
+
+////
+// context.hpp
+
+// A tiny AST node allocated from the parse context.
+struct Node {
+    int value;
+    Node* next;
+    Node(int value, Node* next) : value(value), next(next) { }
+};
+
+// Testing that user actions can allocate from a stream's arena.
+TEST_CASE("ParseContext") {
+    parsical::StringParser p("1 2 3");
+    REQUIRE(p.context() == nullptr);
+    REQUIRE_THROWS_AS(parsical::arenaOf(p), std::runtime_error&);
+
+    parsical::ParseArena arena;
+    parsical::ParseContext context(&arena);
+    p.setContext(&context);
+    REQUIRE(&parsical::arenaOf(p) == &arena);
+
+    Node* list = nullptr;
+    while (!p.eof()) {
+        list = parsical::make<Node>(p, parsical::str::parseInt(p), list);
+        parsical::str::consumeWhitespace(p);
+    }
+
+    REQUIRE(list->value == 3);
+    REQUIRE(list->next->value == 2);
+    REQUIRE(list->next->next->value == 1);
+    REQUIRE(list->next->next->next == nullptr);
+}
+
+////
+// batch.hpp
+
+// A minimal Executor that runs everything on the calling thread, standing in
+// for a user-supplied scheduler.
+struct InlineExecutor : public parsical::Executor {
+    std::size_t calls = 0;
+
+    virtual std::size_t size() const noexcept override { return 1; }
+
+    virtual void run(std::size_t count, std::function<void(std::size_t, std::size_t)> fn) override {
+        calls++;
+        for (std::size_t i = 0; i < count; i++)
+            fn(0, i);
+    }
+};
+
+// Testing that parseBatch reports a result or an error for every document,
+// in order, on both the built-in pool and a custom Executor.
+TEST_CASE("parseBatch") {
+    std::vector<std::string> documents;
+    for (int i = 0; i < 1000; i++)
+        documents.push_back(i % 100 == 7 ? "oops" : std::to_string(i));
+
+    InlineExecutor inlineExecutor;
+    std::vector<std::vector<parsical::BatchResult<int>>> runs {
+        parsical::parseBatch<int>(documents, parsical::str::parseInt),
+        parsical::parseBatch<int>(documents, parsical::str::parseInt, inlineExecutor)
+    };
+    REQUIRE(inlineExecutor.calls == 1);
+
+    // Every worker has an arena to build temporaries in.
+    std::vector<parsical::BatchResult<int>> summed = parsical::parseBatch<int>(documents, [](parsical::ParseStream<char>& stream) -> int {
+        Node* node = parsical::make<Node>(stream, parsical::str::parseInt(stream), nullptr);
+        return node->value;
+    });
+    runs.push_back(summed);
+
+    for (std::vector<parsical::BatchResult<int>>& results: runs) {
+        REQUIRE(results.size() == documents.size());
+        for (int i = 0; i < 1000; i++) {
+            REQUIRE(results[i].ok == (i % 100 != 7));
+            if (results[i].ok)
+                REQUIRE(results[i].value == i);
+            else
+                REQUIRE((results[i].error && results[i].error->position() == 0));
+        }
+    }
+}
+
+////
+// batchreader.hpp
+
+// Reading the same batch of files with and without io_uring.
+TEST_CASE("BatchFileReader") {
+    std::vector<std::string> paths {
+        "res/testfile.txt",
+        tempPath("batch-empty.txt"),
+        tempPath("batch-numbers.txt")
+    };
+
+    std::ofstream(paths[1]).close();
+    std::ofstream numbers(paths[2]);
+    for (int i = 0; i < 1000; i++)
+        numbers << i << ' ';
+    numbers.close();
+
+    for (bool useIoUring: { true, false }) {
+        parsical::BatchFileReader reader(3, 7, useIoUring);
+        if (!useIoUring)
+            REQUIRE(!reader.usingIoUring());
+
+        std::vector<std::string> contents(paths.size());
+        std::vector<int> sums(paths.size(), -1);
+        reader.read(paths, [&](std::size_t i, parsical::ParseStream<char>& stream) {
+            if (i == 2) {
+                int sum = 0;
+                while (!stream.eof()) {
+                    sum += parsical::str::parseInt(stream);
+                    parsical::str::consumeWhitespace(stream);
+                }
+                sums[i] = sum;
+            } else {
+                contents[i] = parsical::str::takeWhile(stream, [](char c) -> bool { return true; });
+            }
+        });
+
+        REQUIRE(contents[0] == "abcdefg\n");
+        REQUIRE(contents[1] == "");
+        REQUIRE(sums[2] == 499500);
+
+        REQUIRE_THROWS_AS(reader.read({ tempPath("batch-missing.txt") }, [](std::size_t, parsical::ParseStream<char>&) { }), std::runtime_error&);
+    }
+}
+
+////
+// failures.hpp
+
+// Testing that the farthest failure and everything expected there gets
+// reported, rather than the last alternative tried.
+TEST_CASE("FailureTracker") {
+    parsical::FailureTracker tracker;
+    REQUIRE(!tracker.failed());
+    tracker.fail(3, 0x1);
+    tracker.fail(1, 0x4);
+    tracker.fail(3, 0x2);
+    REQUIRE(tracker.position() == 3);
+    REQUIRE(tracker.expected() == 0x3);
+    tracker.fail(5, 0);
+    REQUIRE(tracker.expected() == 0);
+
+    parsical::TokenClasses classes;
+    std::uint64_t digit = classes.add("digit");
+    std::uint64_t letter = classes.add("letter");
+    std::uint64_t paren = classes.add("'('");
+    REQUIRE(classes.describe(digit | letter | paren) == "digit, letter or '('");
+    REQUIRE(classes.name(letter) == "letter");
+
+    typedef std::function<char(parsical::ParseStream<char>&)> Term;
+    auto one = [](std::function<bool(char)> pred) -> Term {
+        return [pred](parsical::ParseStream<char>& s) -> char {
+            if (s.eof() || !pred(s.peek()))
+                throw parsical::ParseError(parsical::ErrorCode::Unexpected, "No.", s.pos());
+            return s.get();
+        };
+    };
+    std::vector<Term> terms = {
+        [&](parsical::ParseStream<char>& s) { return parsical::label<char>(s, digit, one(parsical::str::isNumber)); },
+        [&](parsical::ParseStream<char>& s) { return parsical::label<char>(s, letter, one(parsical::str::isAlpha)); },
+        [&](parsical::ParseStream<char>& s) { return parsical::label<char>(s, paren, one([](char c) { return c == '('; })); }
+    };
+    auto sum = [&](parsical::ParseStream<char>& s) -> int {
+        int n = 0;
+        parsical::option<char>(s, terms);
+        while (!s.eof()) {
+            parsical::str::consumeWhitespace(s);
+            parsical::str::string(s, "+");
+            parsical::str::consumeWhitespace(s);
+            parsical::option<char>(s, terms);
+            n++;
+        }
+        return n;
+    };
+
+    REQUIRE(parsical::parseWithDiagnostics<int>("a + 1 + b", classes, sum) == 2);
+
+    try {
+        parsical::parseWithDiagnostics<int>("x + 1\n+ ?", classes, sum);
+        FAIL("parseWithDiagnostics should have thrown.");
+    } catch (parsical::ParseError& e) {
+        REQUIRE(std::string(e.message()) == "expected digit, letter or '(' at 2:3");
+        REQUIRE(e.position() == 8);
+        REQUIRE(e.expected() == (digit | letter | paren));
+        REQUIRE(e.code() == parsical::ErrorCode::NoMatch);
+    }
+}
+
+////
+// iteratorparser.hpp
+
+// Testing the random-access IteratorParser over a container that isn't a
+// std::string.
+TEST_CASE("IteratorParser (random access)") {
+    std::deque<char> input { 'a', 'b', 'c', 'd', 'e', 'f', 'g' };
+    auto p = parsical::makeIteratorParser(input.begin(), input.end());
+    std::vector<char> values(input.begin(), input.end());
+
+    testParser(p, values);
+
+    p.get();
+    p.get();
+    REQUIRE(p.pos() == 2);
+    p.stepBack(1);
+    REQUIRE(p.get() == 'b');
+}
+
+// Testing the IteratorParser over forward, bidirectional and single-pass
+// input iterators.
+TEST_CASE("IteratorParser (forward)") {
+    std::forward_list<char> input { 'a', 'b', 'c', 'd', 'e', 'f', 'g' };
+    auto p = parsical::makeIteratorParser(input.begin(), input.end());
+    std::vector<char> values(input.begin(), input.end());
+
+    testParser(p, values);
+
+    std::list<char> linked(input.begin(), input.end());
+    auto l = parsical::makeIteratorParser(linked.begin(), linked.end());
+    testParser(l, values);
+
+    std::istringstream in("abcdefg");
+    parsical::IteratorParser<std::istreambuf_iterator<char>> q {
+        std::istreambuf_iterator<char>(in),
+        std::istreambuf_iterator<char>()
+    };
+
+    testParser(q, values);
+    REQUIRE(parsical::str::takeWhile(q, parsical::str::isAlpha) == "abcdefg");
+}
+
+// Testing that the forward and single-pass IteratorParsers let go of
+// what's before a cut, and step back across many checkpoints.
+TEST_CASE("IteratorParser (cut)") {
+    std::string text;
+    for (int i = 0; i < 1000; i++)
+        text += static_cast<char>('a' + i % 26);
+
+    std::forward_list<char> input(text.begin(), text.end());
+    auto p = parsical::makeIteratorParser(input.begin(), input.end());
+    parsical::str::takeN(p, 500);
+    p.stepBack(431);
+    REQUIRE(p.get() == text[69]);
+    p.cut();
+    parsical::str::takeN(p, 200);
+    p.stepBack(200);
+    REQUIRE(p.get() == text[70]);
+    REQUIRE_THROWS_AS(p.stepBack(2), parsical::ParseError&);
+
+    std::istringstream in(text);
+    parsical::IteratorParser<std::istreambuf_iterator<char>> q {
+        std::istreambuf_iterator<char>(in),
+        std::istreambuf_iterator<char>()
+    };
+    parsical::str::takeN(q, 300);
+    q.cut();
+    REQUIRE(q.get() == text[300]);
+    q.stepBack(1);
+    REQUIRE_THROWS_AS(q.stepBack(1), parsical::ParseError&);
+}
+
+////
+// lineindex.hpp
+
+// Testing LineIndex lookups against a plain rescan, asking about offsets out
+// of order and across many scanning steps.
+TEST_CASE("LineIndex") {
+    std::string input;
+    for (int i = 0; i < 30000; i++)
+        input += std::string(i % 17, 'x') + (i % 5 == 0 ? "\n\n" : "\n");
+
+    parsical::LineIndex index(input.data(), input.size());
+    for (std::size_t offset: { input.size(), std::size_t(0), std::size_t(1), std::size_t(70000), std::size_t(16), std::size_t(123457), input.size() - 1 }) {
+        std::size_t line = 1 + std::count(input.begin(), input.begin() + offset, '\n');
+        std::size_t start = input.rfind('\n', offset == 0 ? std::string::npos : offset - 1);
+        std::size_t column = offset - (start == std::string::npos || offset == 0 ? 0 : start + 1) + 1;
+
+        parsical::LineCol at = index.lineCol(offset);
+        REQUIRE(at.line == line);
+        REQUIRE(at.column == column);
+    }
+
+    REQUIRE(index.lineCol(input.size() + 100).line == index.lineCol(input.size()).line);
+
+    parsical::StringParser p("ab\ncd\n\nef");
+    REQUIRE(p.lineCol(0).line == 1);
+    REQUIRE(p.lineCol(2).column == 3);
+    REQUIRE(p.lineCol(3).line == 2);
+    REQUIRE(p.lineCol(7).line == 4);
+    REQUIRE(p.lineCol(7).column == 1);
+
+    std::string path = tempPath("lineindex");
+    std::ofstream(path) << input;
+    parsical::MappedFile file(path);
+    REQUIRE(file.lineCol(123457).line == index.lineCol(123457).line);
+    std::remove(path.c_str());
+}
+
+////
+// mappedfile.hpp
+
+// Testing that a MappedFile sees the file's contents.
+TEST_CASE("MappedFile") {
+    parsical::MappedFile file("res/testfile.txt");
+    REQUIRE(std::string(file.data(), file.size()) == "abcdefg\n");
+
+    auto p = parsical::makeIteratorParser(file.data(), file.data() + file.size());
+    REQUIRE(parsical::str::parseString(p) == "abcdefg");
+
+    REQUIRE_THROWS_AS(parsical::MappedFile(tempPath("mapped-missing.txt")), std::runtime_error&);
+}
+
+// Testing positions past 4 GiB, with a sparse file that's mostly a hole
+// followed by a little real input.
+TEST_CASE("MappedFile larger than 4 GiB") {
+    const std::size_t offset = (std::size_t(5) << 30) + 3;
+    std::string path = tempPath("mapped-huge");
+    {
+        std::ofstream out(path, std::ios::binary);
+        out.seekp(offset);
+        out << "tail 42";
+    }
+
+    {
+        parsical::MappedFile file(path);
+        REQUIRE(file.size() == offset + 7);
+
+        parsical::IteratorParser<const char*> p(file.data(), file.data() + file.size());
+        p.reset(file.data() + offset, file.data() + file.size(), offset);
+        REQUIRE(p.pos() == offset);
+        REQUIRE(parsical::str::string(p, "tail") == "tail");
+        parsical::str::consumeWhitespace(p);
+        REQUIRE(parsical::str::parseInt(p) == 42);
+        REQUIRE(p.pos() == file.size());
+
+        try {
+            p.get();
+            FAIL("get should have thrown.");
+        } catch (parsical::ParseError& e) {
+            REQUIRE(e.position() == file.size());
+            REQUIRE(std::string(e.what()) == "Parse error at position " + std::to_string(file.size()) + ": Cannot get after EOF has been reached.");
+        }
+
+        p.stepBack(7);
+        REQUIRE(p.pos() == offset);
+        REQUIRE_THROWS_AS(p.stepBack(1), parsical::ParseError&);
+    }
+
+    // Reading the same file through an istream, seeking straight there.
+    {
+        parsical::IStreamParser p(path);
+        p.seek(offset);
+        REQUIRE(p.pos() == offset);
+        REQUIRE(parsical::str::string(p, "tail") == "tail");
+        parsical::str::consumeWhitespace(p);
+        REQUIRE(parsical::str::parseInt(p) == 42);
+        REQUIRE(p.pos() == offset + 7);
+
+        try {
+            p.get();
+            FAIL("get should have thrown.");
+        } catch (parsical::ParseError& e) {
+            REQUIRE(e.position() == offset + 7);
+        }
+    }
+
+    // And an index pointing past 4 GiB survives being saved and loaded.
+    std::string indexPath = tempPath("mapped-huge.idx");
+    {
+        parsical::RecordIndex index;
+        index.add(0);
+        index.add(offset);
+        index.save(indexPath);
+    }
+    {
+        parsical::RecordIndex loaded(indexPath);
+        REQUIRE(loaded.size() == 2);
+        REQUIRE(loaded[1] == offset);
+
+        parsical::IStreamParser p(path);
+        int value = parsical::parseRecord<int>(p, loaded, 1, [](parsical::ParseStream<char>& s) -> int {
+            parsical::str::string(s, "tail ");
+            return parsical::str::parseInt(s);
+        });
+        REQUIRE(value == 42);
+        REQUIRE(p.pos() == offset + 7);
+    }
+
+    std::remove(path.c_str());
+    std::remove(indexPath.c_str());
+}
+
+////
+// parallel.hpp
+
+// Testing the record splitter.
+TEST_CASE("splitRecords") {
+    std::string input = "aa\nbbbb\nc\ndddddd\n";
+
+    REQUIRE(parsical::splitRecords(input.data(), input.size(), '\n', 1) == (std::vector<std::size_t> { 0, 17 }));
+    REQUIRE(parsical::splitRecords(input.data(), input.size(), '\n', 4) == (std::vector<std::size_t> { 0, 8, 10, 17 }));
+    REQUIRE(parsical::splitRecords(input.data(), input.size(), '\n', 100).back() == 17);
+    REQUIRE(parsical::splitRecords(input.data(), 0, '\n', 4) == (std::vector<std::size_t> { 0, 0 }));
+}
+
+// Testing that parallelMany gives the same results as many, in order, and
+// reports errors at their absolute position.
+TEST_CASE("parallelMany") {
+    parsical::ThreadPool pool(4);
+    REQUIRE(pool.size() == 4);
+
+    std::ostringstream builder;
+    for (int i = 0; i < 5000; i++)
+        builder << i << '\n';
+    std::string input = builder.str();
+
+    auto record = [](parsical::ParseStream<char>& stream) -> int {
+        int n = parsical::str::parseInt(stream);
+        parsical::str::string(stream, "\n");
+        return n;
+    };
+
+    parsical::StringParser p(input);
+    std::vector<int> expected = parsical::many<int>(p, record);
+    REQUIRE(expected.size() == 5000);
+
+    for (std::size_t chunks: { 0, 1, 7, 64 })
+        REQUIRE(parsical::parallelMany<int>(input, '\n', record, pool, chunks) == expected);
+
+    std::string bad = input + "12x\n" + input;
+    try {
+        parsical::parallelMany<int>(bad, '\n', record, pool, 16);
+        FAIL("parallelMany should have thrown.");
+    } catch (parsical::ParseError& e) {
+        REQUIRE(e.code() == parsical::ErrorCode::Unexpected);
+        REQUIRE(e.position() == input.size() + 2);
+        REQUIRE(std::string(e.what()).find("at position " + std::to_string(input.size() + 2)) != std::string::npos);
+    }
+}
+
+// Testing speculativeMany on CSV with newlines inside of quoted fields, both
+// with a hypothesis for every state and with a missing one.
+TEST_CASE("speculativeMany") {
+    parsical::ThreadPool pool(4);
+
+    typedef std::vector<std::string> Row;
+    auto row = [](parsical::ParseStream<char>& stream) -> Row {
+        Row fields;
+        while (true) {
+            std::string field;
+            if (stream.peek() == '"') {
+                stream.get();
+                while (true) {
+                    char c = stream.get();
+                    if (c == '"' && !stream.eof() && stream.peek() == '"')
+                        stream.get();
+                    else if (c == '"')
+                        break;
+                    field += c;
+                }
+            } else {
+                field = parsical::str::takeUntil(stream, [](char c) -> bool { return c == ',' || c == '\n'; });
+            }
+            fields.push_back(field);
+
+            if (stream.get() == '\n')
+                return fields;
+        }
+    };
+
+    // Chunks start right after a newline, so outside of quotes that's
+    // already the start of a row. Inside of quotes the rest of the field
+    // and the rest of its row have to be skipped.
+    enum Quoting { Outside, Inside };
+    auto sync = [](parsical::ParseStream<char>& stream, Quoting q) {
+        if (q == Outside)
+            return;
+
+        while (true) {
+            char c = stream.get();
+            if (c == '"' && !stream.eof() && stream.peek() == '"')
+                stream.get();
+            else if (c == '"')
+                break;
+        }
+        parsical::dropUntil(stream, [](char c) -> bool { return c == '\n'; });
+        stream.get();
+    };
+
+    std::ostringstream builder;
+    for (int i = 0; i < 500; i++) {
+        builder << i << ",\"multi\nline " << i << "\nwith \"\"quotes\"\"\",x\n";
+        builder << "\"" << i << "\n\",plain\n";
+    }
+    std::string input = builder.str();
+
+    parsical::StringParser p(input);
+    std::vector<Row> expected = parsical::many<Row>(p, row);
+    REQUIRE(expected.size() == 1000);
+    REQUIRE(expected[0] == (Row { "0", "multi\nline 0\nwith \"quotes\"", "x" }));
+
+    std::vector<Quoting> both { Outside, Inside };
+    std::vector<Quoting> outside { Outside };
+    for (std::size_t chunks: { 1, 3, 16, 97 }) {
+        REQUIRE(parsical::speculativeMany<Row>(input, '\n', both, sync, row, pool, chunks) == expected);
+        REQUIRE(parsical::speculativeMany<Row>(input, '\n', outside, sync, row, pool, chunks) == expected);
+    }
+
+    REQUIRE_THROWS_AS(parsical::speculativeMany<Row>(input + "\"unterminated", '\n', both, sync, row, pool, 16), parsical::ParseError&);
+}
+
+////
+// pushparser.hpp
+
+// Testing that a FeedParser reports running out of input rather than EOF
+// until it's finished.
+TEST_CASE("FeedParser") {
+    parsical::FeedParser p;
+    p.feed("abc");
+
+    REQUIRE(parsical::str::string(p, "abc") == "abc");
+    REQUIRE(!p.starved());
+    REQUIRE(!p.eof());
+    REQUIRE(p.starved());
+    REQUIRE_THROWS_AS(p.peek(), parsical::NeedMoreInput&);
+
+    p.feed("defg");
+    p.finish();
+    REQUIRE_THROWS(p.feed("h"));
+
+    p.stepBack(3);
+    testParser(p, std::vector<char> { 'a', 'b', 'c', 'd', 'e', 'f', 'g' });
+
+    p.get();
+    p.get();
+    p.discardConsumed();
+    REQUIRE(p.pos() == 2);
+    REQUIRE_THROWS(p.stepBack(1));
+    REQUIRE(p.get() == 'c');
+}
+
+// Testing that a PushParser suspends on partial records and resumes from
+// where the partial record started.
+TEST_CASE("PushParser") {
+    parsical::PushParser<int> p([](parsical::ParseStream<char>& stream) -> int {
+        int n = parsical::str::parseInt(stream);
+        if (!stream.eof())
+            parsical::str::string(stream, ",");
+        return n;
+    });
+
+    REQUIRE(p.feed("12") == parsical::PushStatus::Suspended);
+    REQUIRE(p.take().empty());
+
+    REQUIRE(p.feed("3,45") == parsical::PushStatus::Suspended);
+    REQUIRE(p.take() == (std::vector<int> { 123 }));
+    REQUIRE(p.getStream().pos() == 4);
+
+    REQUIRE(p.feed("6,7") == parsical::PushStatus::Suspended);
+    REQUIRE(p.finish() == parsical::PushStatus::Done);
+    REQUIRE(p.take() == (std::vector<int> { 456, 7 }));
+
+    parsical::PushParser<int> q(parsical::str::parseInt);
+    REQUIRE_THROWS_AS(q.feed("x"), parsical::ParseError&);
+}
+
+// Testing that a PushParser doesn't retry a starved record until enough
+// input has arrived to finish it, and copes with many records in one feed.
+TEST_CASE("PushParser (resuming)") {
+    int calls = 0;
+    parsical::PushParser<std::string> p([&calls](parsical::ParseStream<char>& stream) -> std::string {
+        calls++;
+        return parsical::str::takeN(stream, 100);
+    });
+
+    std::string record(100, 'x');
+    for (char c: record)
+        REQUIRE(p.feed(&c, 1) == parsical::PushStatus::Suspended);
+    REQUIRE(calls == 2);
+    REQUIRE(p.take() == (std::vector<std::string> { record }));
+
+    std::string many;
+    for (int i = 0; i < 100000; i++)
+        many += std::to_string(i) + ",";
+
+    parsical::PushParser<int> q([](parsical::ParseStream<char>& stream) -> int {
+        int n = parsical::str::parseInt(stream);
+        parsical::str::string(stream, ",");
+        return n;
+    });
+
+    REQUIRE(q.feed(many) == parsical::PushStatus::Suspended);
+    std::vector<int> values = q.take();
+    REQUIRE(values.size() == 100000);
+    REQUIRE(values.back() == 99999);
+    REQUIRE(q.getStream().available() == 0);
+}
+
+////
+// decompressparser.hpp
+
+// Testing the decompressing parser over a small gzip file.
+TEST_CASE("DecompressParser") {
+    if (!parsical::DecompressParser::supports(parsical::Compression::Gzip))
+        return;
+
+    parsical::DecompressParser p("res/testfile.txt.gz", parsical::Compression::Auto, 4, 2);
+    std::vector<char> values { 'a', 'b', 'c', 'd', 'e', 'f', 'g', '\n' };
+
+    for (char c: values)
+        REQUIRE(p.get() == c);
+    REQUIRE(p.eof());
+    REQUIRE_THROWS(p.get());
+
+    p.stepBack(4);
+    REQUIRE(p.get() == 'e');
+
+    parsical::DecompressStats stats = p.stats();
+    REQUIRE(stats.decompressedBytes == values.size());
+    REQUIRE(stats.compressedBytes == 28);
+    REQUIRE(stats.inflateSeconds >= 0);
+
+    REQUIRE_THROWS_AS(parsical::DecompressParser("res/doesnotexist.txt.gz"), std::runtime_error&);
+}
+
+// Testing that concatenated gzip members are read one after another, and
+// that truncated input fails as a ParseError once the good data runs out.
+TEST_CASE("DecompressParser (concatenated and truncated)") {
+    if (!parsical::DecompressParser::supports(parsical::Compression::Gzip))
+        return;
+
+    auto parseNumbers = [](parsical::ParseStream<char>& stream) -> std::vector<int> {
+        return parsical::many<int>(stream, [](parsical::ParseStream<char>& stream) -> int {
+            int n = parsical::str::parseInt(stream);
+            parsical::str::consumeWhitespace(stream);
+            return n;
+        });
+    };
+
+    parsical::DecompressParser p("res/numbers.txt.gz", parsical::Compression::Gzip, 256, 3);
+    std::vector<int> values = parseNumbers(p);
+
+    REQUIRE(p.eof());
+    REQUIRE(values.size() == 10000);
+    REQUIRE(values.back() == 9999);
+
+    std::ifstream full("res/numbers.txt.gz", std::ios::binary);
+    std::string compressed((std::istreambuf_iterator<char>(full)), std::istreambuf_iterator<char>());
+    std::istringstream truncated(compressed.substr(0, compressed.size() / 4));
+
+    parsical::DecompressParser q(truncated, parsical::Compression::Gzip, 256, 3);
+    REQUIRE_THROWS_AS(while (true) q.get(), parsical::ParseError&);
+    REQUIRE(q.pos() > 0);
+    REQUIRE(q.failed());
+    REQUIRE(!q.eof());
+
+    // Going through many, truncated input mustn't look like a shorter,
+    // complete one.
+    truncated.clear();
+    truncated.seekg(0);
+    parsical::DecompressParser r(truncated, parsical::Compression::Gzip, 256, 3);
+    REQUIRE_THROWS_AS(parseNumbers(r), parsical::ParseError&);
+    REQUIRE(r.failed());
+
+    // Nor may a truncated member that follows a complete one, even when the
+    // block that ends the first holds all that there is of the second.
+    std::istringstream trailing(compressed + compressed.substr(0, 200));
+    parsical::DecompressParser s(trailing, parsical::Compression::Gzip, 1 << 16, 3);
+    REQUIRE_THROWS_AS(parseNumbers(s), parsical::ParseError&);
+    REQUIRE(s.failed());
+}
+
+// Testing that the helper thread blocks while the buffer is full, and that
+// destroying a parser that hasn't read everything doesn't wait on it.
+TEST_CASE("DecompressParser (blocking)") {
+    if (!parsical::DecompressParser::supports(parsical::Compression::Gzip))
+        return;
+
+    parsical::DecompressParser p("res/numbers.txt.gz", parsical::Compression::Gzip, 256, 2);
+    p.get();
+    std::clock_t before = std::clock();
+    std::this_thread::sleep_for(std::chrono::milliseconds(200));
+    double busy = static_cast<double>(std::clock() - before) / CLOCKS_PER_SEC;
+    REQUIRE(busy < 0.1);
+}
+
+////
+// readaheadparser.hpp
+
+// Testing the read-ahead file parser in the same way as the IStreamParser.
+TEST_CASE("ReadAheadParser") {
+    parsical::ReadAheadParser p("res/testfile.txt", 4, 2);
+    std::vector<char> values { 'a', 'b', 'c', 'd', 'e', 'f', 'g', '\n' };
+
+    for (char c: values)
+        REQUIRE(p.get() == c);
+    REQUIRE(p.eof());
+    REQUIRE_THROWS(p.get());
+
+    // Only a block's worth of backtracking is kept.
+    REQUIRE_THROWS(p.stepBack(values.size()));
+    p.stepBack(4);
+    REQUIRE(p.get() == 'e');
+
+    parsical::ReadAheadStats stats = p.stats();
+    REQUIRE(stats.bytesRead == values.size());
+    REQUIRE(stats.ioWaitSeconds >= 0);
+    REQUIRE(stats.parseSeconds >= 0);
+
+    REQUIRE_THROWS_AS(parsical::ReadAheadParser("res/doesnotexist.txt"), std::runtime_error&);
+}
+
+// Testing a ReadAheadParser over an input much bigger than its buffers.
+TEST_CASE("ReadAheadParser (large)") {
+    std::ostringstream builder;
+    for (int i = 0; i < 10000; i++)
+        builder << i << ' ';
+    std::istringstream in(builder.str());
+
+    parsical::ReadAheadParser p(in, 64, 3);
+    std::vector<int> values = parsical::many<int>(p, [](parsical::ParseStream<char>& stream) -> int {
+        int n = parsical::str::parseInt(stream);
+        parsical::str::consumeWhitespace(stream);
+        return n;
+    });
+
+    REQUIRE(p.eof());
+    REQUIRE(values.size() == 10000);
+    REQUIRE(values.back() == 9999);
+    REQUIRE(p.stats().bytesRead == builder.str().size());
+}
+
+// Testing that a read error part way through isn't taken for the end of the
+// input.
+TEST_CASE("ReadAheadParser (read error)") {
+    std::ostringstream builder;
+    for (int i = 0; i < 10000; i++)
+        builder << i << ' ';
+
+    BrokenBuf buf(builder.str(), 1000);
+    std::istream in(&buf);
+
+    parsical::ReadAheadParser p(in, 64, 3);
+    REQUIRE_THROWS_AS(parsical::many<int>(p, [](parsical::ParseStream<char>& stream) -> int {
+        int n = parsical::str::parseInt(stream);
+        parsical::str::consumeWhitespace(stream);
+        return n;
+    }), parsical::ParseError&);
+
+    REQUIRE(p.failed());
+    REQUIRE(!p.eof());
+
+    // The error is where the good input runs out.
+    REQUIRE_THROWS_AS(while (true) p.get(), parsical::ParseError&);
+    REQUIRE(p.pos() == p.stats().bytesRead);
+    REQUIRE(p.pos() <= 1000);
+}
+
+// Testing that the reader thread blocks rather than spins while the parser
+// is busy, that idle time isn't counted as parsing, and that the bulk
+// operations work across the end of the ring.
+TEST_CASE("ReadAheadParser (blocking)") {
+    std::string input;
+    for (int i = 0; i < 100000; i++)
+        input += static_cast<char>('a' + i % 26);
+    std::istringstream in(input);
+
+    parsical::ReadAheadParser p(in, 64, 2);
+    REQUIRE(p.get() == 'a');
+
+    std::clock_t cpu = std::clock();
+    std::this_thread::sleep_for(std::chrono::milliseconds(200));
+    double busy = static_cast<double>(std::clock() - cpu) / CLOCKS_PER_SEC;
+    REQUIRE(busy < 0.1);
+    REQUIRE(p.stats().parseSeconds < 0.1);
+
+    std::string seen = "a";
+    while (seen.size() + 50 <= input.size()) {
+        parsical::Span<char> ahead = p.peekN(50);
+        seen.append(ahead.begin(), ahead.end());
+        p.advance(50);
+        p.cut();
+    }
+    while (!p.eof())
+        seen += p.get();
+
+    REQUIRE(seen == input);
+}
+
+////
+// recordindex.hpp
+
+// Testing that an index built while parsing once can be saved, mapped back
+// in and used to parse single records out of the middle of the input.
+TEST_CASE("RecordIndex") {
+    std::string input;
+    for (int i = 0; i < 1000; i++)
+        input += "r" + std::to_string(i) + "," + std::to_string(i * 7) + "\n";
+
+    std::string dataPath = tempPath("records.txt");
+    std::string indexPath = tempPath("records.idx");
+    std::ofstream(dataPath) << input;
+
+    auto record = [](parsical::ParseStream<char>& s) -> int {
+        parsical::str::takeUntil(s, [](char c) { return c == ','; });
+        parsical::str::string(s, ",");
+        int value = parsical::str::parseInt(s);
+        parsical::str::string(s, "\n");
+        return value;
+    };
+
+    {
+        parsical::IStreamParser p(dataPath);
+        parsical::RecordIndex index;
+        REQUIRE(parsical::indexedMany<int>(p, record, index).size() == 1000);
+        REQUIRE(index.size() == 1000);
+        REQUIRE(index[0] == 0);
+        REQUIRE(index[1] == 5);
+        index.save(indexPath);
+    }
+
+    parsical::RecordIndex loaded(indexPath);
+    REQUIRE(loaded.size() == 1000);
+    std::uint64_t index742 = loaded[742];
+    REQUIRE_THROWS_AS(loaded.add(0), std::logic_error&);
+
+    parsical::IStreamParser p(dataPath);
+    REQUIRE(parsical::parseRecord<int>(p, loaded, 742, record) == 742 * 7);
+    REQUIRE(parsical::parseRecord<int>(p, loaded, 3, record) == 21);
+    REQUIRE_THROWS_AS(parsical::parseRecord<int>(p, loaded, 1000, record), parsical::ParseError&);
+
+    parsical::MappedFile file(dataPath);
+    parsical::IteratorParser<const char*> q(file.data(), file.data() + file.size());
+    REQUIRE(parsical::parseRecord<int>(q, loaded, 999, record) == 999 * 7);
+    REQUIRE(q.eof());
+
+    REQUIRE_THROWS_AS(parsical::RecordIndex(tempPath("records.txt")), std::runtime_error&);
+
+    // Moving an index, loaded or built, leaves the old one empty.
+    parsical::RecordIndex moved(std::move(loaded));
+    REQUIRE(moved.size() == 1000);
+    REQUIRE(moved[742] == index742);
+    REQUIRE(loaded.size() == 0);
+
+    parsical::RecordIndex built;
+    built.add(3);
+    loaded = std::move(built);
+    REQUIRE(loaded.size() == 1);
+    REQUIRE(loaded[0] == 3);
+    REQUIRE(built.size() == 0);
+
+    // An index with a partial entry on the end is as bad as a short one.
+    std::string badPath = tempPath("records-bad.idx");
+    {
+        std::ifstream in(indexPath, std::ios::binary);
+        std::ofstream out(badPath, std::ios::binary);
+        out << in.rdbuf() << "abc";
+    }
+    REQUIRE_THROWS_AS(parsical::RecordIndex(tempPath("records-bad.idx")), std::runtime_error&);
+
+    std::remove(dataPath.c_str());
+    std::remove(indexPath.c_str());
+    std::remove(badPath.c_str());
+}
+
+////
+// reverseparser.hpp
+
+// Testing that a ReverseParser reads from the end, both over memory and over
+// a file read a few bytes at a time.
+TEST_CASE("ReverseParser") {
+    const char* text = "abcdefg";
+    parsical::ReverseParser p(text, 7);
+    testParser(p, std::vector<char> { 'g', 'f', 'e', 'd', 'c', 'b', 'a' });
+
+    parsical::ReverseParser q(std::string("res/testfile.txt"), 3);
+    testParser(q, std::vector<char> { '\n', 'g', 'f', 'e', 'd', 'c', 'b', 'a' });
+
+    std::string lines = "one\ntwo\nthree";
+    parsical::ReverseParser r(lines.data(), lines.size());
+    REQUIRE(r.previousRecordStart('\n') == 8);
+    REQUIRE(r.offset() == 7);
+    REQUIRE(r.previousRecordStart('\n') == 4);
+    REQUIRE(r.previousRecordStart('\n') == 0);
+    REQUIRE(r.eof());
+
+    REQUIRE_THROWS_AS(parsical::ReverseParser(tempPath("reverse-missing"), 16), std::runtime_error&);
+}
+
+// Testing that tailRecords finds and parses only the last few records,
+// whether or not the input ends with a delimiter.
+TEST_CASE("tailRecords") {
+    std::string input;
+    for (int i = 0; i < 5000; i++)
+        input += std::to_string(i) + "\n";
+
+    auto record = [](parsical::ParseStream<char>& s) -> int {
+        int value = parsical::str::parseInt(s);
+        parsical::str::string(s, "\n");
+        return value;
+    };
+
+    std::vector<int> last = parsical::tailRecords<int>(input.data(), input.size(), '\n', 3, record);
+    REQUIRE(last == (std::vector<int> { 4997, 4998, 4999 }));
+
+    std::string path = tempPath("tail.log");
+    std::ofstream(path) << input;
+    REQUIRE(parsical::tailRecords<int>(path, '\n', 3, record) == last);
+
+    parsical::ReverseParser blocks(path, 5);
+    std::vector<std::pair<std::size_t, std::size_t>> bounds = parsical::tailBounds(blocks, '\n', 2);
+    REQUIRE(bounds.size() == 2);
+    REQUIRE(input.substr(bounds[0].first, bounds[0].second - bounds[0].first) == "4999\n");
+    REQUIRE(input.substr(bounds[1].first, bounds[1].second - bounds[1].first) == "4998\n");
+
+    // Read or mapped, a parser that reads to the end only sees its record.
+    auto rest = [](parsical::ParseStream<char>& s) -> std::string {
+        std::string str;
+        while (!s.eof())
+            str += s.get();
+        return str;
+    };
+    std::vector<std::string> whole { "4998\n", "4999\n" };
+    REQUIRE(parsical::tailRecords<std::string>(input.data(), input.size(), '\n', 2, rest) == whole);
+    REQUIRE(parsical::tailRecords<std::string>(path, '\n', 2, rest) == whole);
+
+    parsical::MappedFile file(path);
+    REQUIRE(parsical::tailRecords<int>(file, '\n', 6000, record).size() == 5000);
+
+    std::string unterminated = "1\n2\n3";
+    auto value = [](parsical::ParseStream<char>& s) { return parsical::str::parseInt(s); };
+    REQUIRE(parsical::tailRecords<int>(unterminated.data(), unterminated.size(), '\n', 2, value) == (std::vector<int> { 2, 3 }));
+    REQUIRE(parsical::tailRecords<int>(unterminated.data(), 0, '\n', 2, value).empty());
+
+    std::remove(path.c_str());
+}
+
+////
+// ringparser.hpp
+
+// Testing a RingParser fed from a single thread.
+TEST_CASE("RingParser") {
+    parsical::RingBuffer ring(16);
+    parsical::RingParser p(ring, 8);
+    std::string input = "abcdefg";
+
+    REQUIRE(ring.capacity() == 16);
+    REQUIRE_THROWS(parsical::RingParser(ring, 16));
+
+    ring.writeAll(input.data(), input.size());
+    ring.close();
+
+    testParser(p, std::vector<char>(input.begin(), input.end()));
+}
+
+// Testing a RingParser being fed by another thread, through a buffer much
+// smaller than the input.
+TEST_CASE("RingParser (threaded)") {
+    parsical::RingBuffer ring(64);
+    parsical::RingParser p(ring, 16);
+
+    std::thread producer([&ring]() {
+        for (int i = 0; i < 10000; i++) {
+            std::string s = std::to_string(i) + ",";
+            ring.writeAll(s.data(), s.size());
+        }
+        ring.close();
+    });
+
+    std::vector<int> values = parsical::many<int>(p, [](parsical::ParseStream<char>& stream) -> int {
+        int n = parsical::str::parseInt(stream);
+        parsical::str::string(stream, ",");
+        return n;
+    });
+    producer.join();
+
+    REQUIRE(p.eof());
+    REQUIRE(values.size() == 10000);
+    for (int i = 0; i < 10000; i++)
+        REQUIRE(values[i] == i);
+
+    REQUIRE_NOTHROW(p.stepBack(16));
+    REQUIRE_THROWS(p.stepBack(64));
+}
+
+////
+// smallvector.hpp
+
+// Testing SmallVector's inline storage, growth, copies and moves.
+TEST_CASE("SmallVector") {
+    parsical::SmallVector<std::string, 2> v;
+    REQUIRE(v.empty());
+    REQUIRE(v.capacity() == 2);
+
+    v.push_back("a");
+    v.emplace_back("b");
+    REQUIRE(v.isInline());
+
+    v.push_back(v[0]);
+    REQUIRE(!v.isInline());
+    REQUIRE(v.size() == 3);
+    REQUIRE(v.back() == "a");
+
+    parsical::SmallVector<std::string, 2> copy(v);
+    REQUIRE(copy == v);
+
+    parsical::SmallVector<std::string, 2> moved(std::move(copy));
+    REQUIRE(moved == v);
+    REQUIRE(copy.empty());
+
+    parsical::SmallVector<std::string, 2> small;
+    small.push_back("x");
+    moved = std::move(small);
+    REQUIRE(moved.size() == 1);
+    REQUIRE(moved.isInline());
+    REQUIRE(moved[0] == "x");
+
+    moved.pop_back();
+    REQUIRE(moved.empty());
+    REQUIRE(moved != v);
+}
+
+////
+// symbols.hpp
+
+// Testing that interning hands back the same id and view for a repeated
+// name, including after the table has grown.
+TEST_CASE("SymbolTable") {
+    parsical::SymbolTable table(2);
+
+    parsical::Symbol foo = table.intern("foo");
+    parsical::Symbol bar = table.intern("bar");
+    REQUIRE(foo.id == 0);
+    REQUIRE(bar.id == 1);
+    REQUIRE(foo != bar);
+
+    for (int i = 0; i < 1000; i++)
+        table.intern("name" + std::to_string(i));
+    REQUIRE(table.size() == 1002);
+
+    parsical::Symbol again = table.intern(std::string("foo"));
+    REQUIRE(again == foo);
+    REQUIRE(again.view.data == foo.view.data);
+    REQUIRE(table.name(bar.id).str() == "bar");
+    REQUIRE(table.intern("").view.empty());
+    REQUIRE_THROWS_AS(table.name(5000), std::out_of_range&);
+}
+
+// Testing internedIdentifier on its own and from several threads sharing a
+// concurrent table.
+TEST_CASE("internedIdentifier") {
+    parsical::SymbolTable table(16, true);
+    REQUIRE(table.isConcurrent());
+
+    parsical::StringParser p("abc def abc");
+    parsical::Symbol a = parsical::str::internedIdentifier(p, table);
+    REQUIRE_THROWS_AS(parsical::str::internedIdentifier(p, table), parsical::ParseError&);
+    parsical::str::consumeWhitespace(p);
+    parsical::Symbol d = parsical::str::internedIdentifier(p, table);
+    parsical::str::consumeWhitespace(p);
+    REQUIRE(parsical::str::internedIdentifier(p, table) == a);
+    REQUIRE(a != d);
+    REQUIRE(a.view.str() == "abc");
+
+    std::vector<std::thread> threads;
+    std::vector<std::vector<std::uint32_t>> ids(4);
+    for (int t = 0; t < 4; t++) {
+        threads.push_back(std::thread([&table, &ids, t]() {
+            for (int i = 0; i < 200; i++)
+                ids[t].push_back(table.intern("sym" + std::to_string(i)).id);
+        }));
+    }
+    for (std::thread& t: threads)
+        t.join();
+
+    REQUIRE(table.size() == 202);
+    for (int t = 1; t < 4; t++)
+        REQUIRE(ids[t] == ids[0]);
+}
+
+////
+// threadpool.hpp
+
+// Testing that every index gets run exactly once, and that errors make it
+// back to the caller.
+TEST_CASE("ThreadPool") {
+    parsical::ThreadPool pool(3);
+
+    std::vector<int> counts(1000, 0);
+    std::vector<std::size_t> workers(1000, 0);
+    pool.run(counts.size(), [&](std::size_t worker, std::size_t i) {
+        counts[i]++;
+        workers[i] = worker;
+    });
+    REQUIRE(counts == std::vector<int>(1000, 1));
+    for (std::size_t worker: workers)
+        REQUIRE(worker < 3);
+
+    REQUIRE_THROWS_AS(pool.run(10, [](std::size_t, std::size_t i) {
+        if (i == 5)
+            throw std::runtime_error("five");
+    }), std::runtime_error&);
+
+    pool.run(0, [](std::size_t, std::size_t) { });
+}
+
+// Testing many small runs back to back, where each job is torn down as soon
+// as its last task finishes, while other workers are still looking for work.
+TEST_CASE("ThreadPool (back to back)") {
+    parsical::ThreadPool pool(4);
+
+    std::atomic<int> total(0);
+    for (int i = 0; i < 2000; i++)
+        pool.run(1 + i % 3, [&total](std::size_t, std::size_t) { total++; });
+    REQUIRE(total.load() == 3999);
+}
+
+////
+// segmentedparser.hpp
+
+// Testing the SegmentedParser over a handful of chunks, including an empty
+// one.
+TEST_CASE("SegmentedParser") {
+    std::string a = "ab", b = "", c = "cde", d = "fg";
+    parsical::SegmentedParser p({
+        { a.data(), a.size() },
+        { b.data(), b.size() },
+        { c.data(), c.size() },
+        { d.data(), d.size() }
+    });
+    std::vector<char> values { 'a', 'b', 'c', 'd', 'e', 'f', 'g' };
+
+    testParser(p, values);
+
+    // Stepping back across a segment boundary.
+    parsical::str::string(p, "abcdef");
+    p.stepBack(5);
+    REQUIRE(p.pos() == 1);
+    REQUIRE(p.get() == 'b');
+    REQUIRE(p.get() == 'c');
+
+    // Peeking inside a single segment shouldn't copy anything.
+    parsical::Span<char> inside = p.peekN(2);
+    REQUIRE(inside.data == c.data() + 1);
+    REQUIRE(inside.str() == "de");
+
+    // Peeking across a boundary should.
+    parsical::Span<char> across = p.peekN(4);
+    REQUIRE(across.str() == "defg");
+    REQUIRE(p.pos() == 3);
+
+    REQUIRE_THROWS(p.peekN(5));
+}
+
+////
+// parseerror.hpp
+
+// Testing that errors carry a code and position, and only format their
+// message when it's asked for.
+TEST_CASE("ParseError") {
+    parsical::ParseError lazy(parsical::ErrorCode::Unexpected, "Expected a thing.", 12, 0x5);
+    REQUIRE(lazy.code() == parsical::ErrorCode::Unexpected);
+    REQUIRE(lazy.position() == 12);
+    REQUIRE(lazy.expected() == 0x5);
+    REQUIRE(std::string(lazy.message()) == "Expected a thing.");
+    REQUIRE(std::string(lazy.what()) == "Parse error at position 12: Expected a thing.");
+
+    parsical::ParseError custom(std::string("Made up."));
+    parsical::ParseError copy(custom);
+    REQUIRE(copy.code() == parsical::ErrorCode::Custom);
+    REQUIRE(copy.position() == parsical::ParseError::npos);
+    REQUIRE(std::string(copy.what()) == "Parse error: Made up.");
+
+    parsical::StringParser p("ab");
+    p.get();
+    p.get();
+    try {
+        p.get();
+        FAIL("get should have thrown.");
+    } catch (parsical::ParseError& e) {
+        REQUIRE(e.code() == parsical::ErrorCode::EndOfInput);
+        REQUIRE(e.position() == 2);
+    }
+}
+
 ////
 // general.hpp
 
@@ -204,6 +1831,153 @@ TEST_CASE("manyOne") {
     REQUIRE(parsical::manyOne<char>(p, std::bind(parsical::oneOf<char>, std::placeholders::_1, set)) == test2);
 }
 
+// Attempting to perform a manySmall, both staying inline and spilling onto
+// the heap.
+TEST_CASE("manySmall") {
+    auto letter = [](parsical::ParseStream<char>& c) -> char {
+        if (!parsical::str::isAlpha(c.peek()))
+            throw parsical::ParseError("DONE");
+        return c.get();
+    };
+
+    parsical::StringParser p("abc1abcdefgh");
+
+    parsical::SmallVector<char, 4> few = parsical::manySmall<char, 4>(p, letter);
+    REQUIRE(few.size() == 3);
+    REQUIRE(few.isInline());
+    REQUIRE(few[2] == 'c');
+
+    REQUIRE_THROWS((parsical::manyOneSmall<char, 4>(p, letter)));
+    REQUIRE(p.get() == '1');
+
+    parsical::SmallVector<char, 4> more = parsical::manyOneSmall<char, 4>(p, letter);
+    REQUIRE(more.size() == 8);
+    REQUIRE(!more.isInline());
+    REQUIRE(std::string(more.begin(), more.end()) == "abcdefgh");
+}
+
+// Attempting to perform a count.
+TEST_CASE("count") {
+    parsical::StringParser p("aaab");
+    auto a = [](parsical::ParseStream<char>& c) -> char {
+        if (c.peek() != 'a')
+            throw parsical::ParseError("not an a");
+        return c.get();
+    };
+
+    std::vector<char> two = parsical::count<char>(p, 2, a);
+    REQUIRE(two == (std::vector<char> { 'a', 'a' }));
+    REQUIRE(two.capacity() == 2);
+    REQUIRE(parsical::count<char>(p, 0, a).empty());
+    REQUIRE_THROWS(parsical::count<char>(p, 2, a));
+}
+
+// A StringParser that counts how often it's forked.
+struct ForkCountingParser : public parsical::StringParser {
+    mutable int forks = 0;
+
+    ForkCountingParser(std::string str) : parsical::StringParser(str) { }
+
+    virtual std::unique_ptr<parsical::ParseStream<char>> fork() const override {
+        forks++;
+        return parsical::StringParser::fork();
+    }
+};
+
+// Testing lookAhead and notFollowedBy on a stream that rewinds in place, on
+// one that forks, and on one that can do neither cheaply.
+TEST_CASE("lookAhead") {
+    auto keyword = [](parsical::ParseStream<char>& s) { return parsical::str::string(s, "let"); };
+    auto letter = [](parsical::ParseStream<char>& s) -> char {
+        if (!parsical::str::isAlpha(s.peek()))
+            throw parsical::ParseError(parsical::ErrorCode::Unexpected, "Expected a letter.", s.pos());
+        return s.get();
+    };
+
+    parsical::StringParser p("let x");
+    std::istringstream in("lets");
+    parsical::IStreamParser q(in);
+
+    REQUIRE(parsical::lookAhead<std::string>(p, keyword) == "let");
+    REQUIRE(parsical::lookAhead<std::string>(q, keyword) == "let");
+    REQUIRE(p.pos() == 0);
+    REQUIRE(q.pos() == 0);
+
+    parsical::str::string(p, "let");
+    parsical::str::string(q, "let");
+    parsical::notFollowedBy(p, letter);
+    REQUIRE_THROWS_AS(parsical::notFollowedBy(q, letter), parsical::ParseError&);
+    REQUIRE(p.pos() == 3);
+    REQUIRE(q.pos() == 3);
+    REQUIRE_THROWS((parsical::lookAhead<char>(p, letter)));
+    REQUIRE(p.pos() == 3);
+
+    ForkCountingParser r("let x");
+    REQUIRE(parsical::lookAhead<std::string>(r, keyword) == "let");
+    REQUIRE_THROWS_AS(parsical::notFollowedBy(r, letter), parsical::ParseError&);
+    REQUIRE(r.pos() == 0);
+    REQUIRE(r.forks == 0);
+
+    CountingStream c("let x");
+    REQUIRE(parsical::lookAhead<std::string>(c, keyword) == "let");
+    REQUIRE(c.pos() == 0);
+}
+
+// Testing that choice commits to an alternative once it consumes input,
+// unless it's wrapped in attempt.
+TEST_CASE("choice") {
+    typedef std::function<std::string(parsical::ParseStream<char>&)> Keyword;
+    auto keyword = [](std::string word) -> Keyword {
+        return [word](parsical::ParseStream<char>& s) { return parsical::str::string(s, word); };
+    };
+
+    parsical::StringParser p("lex");
+    REQUIRE_THROWS_AS(parsical::choice<std::string>(p, std::vector<Keyword> { keyword("let"), keyword("lex") }), parsical::ParseError&);
+    REQUIRE(p.pos() == 2);
+
+    parsical::StringParser q("lex");
+    std::vector<Keyword> attempted = {
+        [&](parsical::ParseStream<char>& s) { return parsical::attempt<std::string>(s, keyword("let")); },
+        keyword("lex")
+    };
+    REQUIRE(parsical::choice<std::string>(q, attempted) == "lex");
+
+    parsical::StringParser r("x");
+    REQUIRE(parsical::choice<std::string>(r, std::vector<Keyword> { keyword("a"), keyword("x") }) == "x");
+}
+
+// Testing that a cut stops tryParse and option from backtracking, and lets
+// an IStreamParser drop what it was keeping around.
+TEST_CASE("cut") {
+    std::istringstream in("abcdef");
+    parsical::IStreamParser p(in);
+
+    typedef std::function<char(parsical::ParseStream<char>&)> Branch;
+    std::vector<Branch> branches = {
+        [](parsical::ParseStream<char>& s) -> char {
+            s.get();
+            parsical::cut(s);
+            parsical::str::string(s, "xx");
+            return 'x';
+        },
+        [](parsical::ParseStream<char>& s) -> char {
+            parsical::str::string(s, "ab");
+            return 'a';
+        }
+    };
+
+    REQUIRE_THROWS_AS(parsical::option<char>(p, branches), parsical::ParseError&);
+    REQUIRE(p.lastCut() == 1);
+    REQUIRE(p.pos() == 1);
+    REQUIRE_THROWS_AS(p.stepBack(1), parsical::ParseError&);
+    REQUIRE(p.get() == 'b');
+
+    // Anything that started after the cut rewinds as usual.
+    REQUIRE_THROWS((parsical::tryParse<std::string>(p, [](parsical::ParseStream<char>& s) { return parsical::str::string(s, "cdx"); })));
+    REQUIRE(p.pos() == 2);
+    REQUIRE(p.get() == 'c');
+}
+
 // Attempting to perform an option.
 TEST_CASE("option") {
     parsical::StringParser p("aaabcdeeeef");
@@ -231,11 +2005,141 @@ TEST_CASE("option") {
     REQUIRE(parsical::option<char>(p, fns) == 'b');
     REQUIRE(parsical::option<char>(p, fns) == 'c');
 
-    int pos = p.pos();
+    std::size_t pos = p.pos();
     REQUIRE_THROWS(parsical::option<char>(p, fns));
     REQUIRE(pos == p.pos());
 }
 
+// Testing that many stops at the end of good input, but doesn't mistake bad
+// input for it.
+TEST_CASE("many (failed input)") {
+    BrokenStream good("ab1", 10);
+    REQUIRE(parsical::many<char>(good, letter).size() == 2);
+
+    BrokenStream bad("abcd", 2);
+    REQUIRE_THROWS_AS(parsical::many<char>(bad, letter), parsical::ParseError&);
+    REQUIRE(bad.pos() == 2);
+
+    BrokenStream allocated("abcd", 2);
+    REQUIRE_THROWS_AS(parsical::many<char>(allocated, letter, std::allocator<char>()), parsical::ParseError&);
+}
+
+// Testing the same of manySmall.
+TEST_CASE("manySmall (failed input)") {
+    BrokenStream bad("abcd", 2);
+    REQUIRE_THROWS_AS((parsical::manySmall<char, 4>(bad, letter)), parsical::ParseError&);
+}
+
+// Testing the same of indexedMany.
+TEST_CASE("indexedMany (failed input)") {
+    BrokenStream bad("abcd", 2);
+    parsical::RecordIndex index;
+    REQUIRE_THROWS_AS(parsical::indexedMany<char>(bad, letter, index), parsical::ParseError&);
+    REQUIRE(index.size() == 2);
+}
+
+// Testing that option and choice pass on bad input rather than trying the
+// next alternative and reporting that nothing matched.
+TEST_CASE("option (failed input)") {
+    typedef std::function<char(parsical::ParseStream<char>&)> Fn;
+    std::vector<Fn> fns { letter, parsical::str::parseDigit };
+
+    BrokenStream bad("abcd", 0);
+    try {
+        parsical::option<char>(bad, fns);
+        FAIL("option should have thrown.");
+    } catch (parsical::ParseError& e) {
+        REQUIRE(e.code() == parsical::ErrorCode::Generic);
+    }
+}
+
+TEST_CASE("choice (failed input)") {
+    typedef std::function<char(parsical::ParseStream<char>&)> Fn;
+    std::vector<Fn> fns { letter, parsical::str::parseDigit };
+
+    BrokenStream bad("abcd", 0);
+    try {
+        parsical::choice<char>(bad, fns);
+        FAIL("choice should have thrown.");
+    } catch (parsical::ParseError& e) {
+        REQUIRE(e.code() == parsical::ErrorCode::Generic);
+    }
+}
+
+// Testing that bad input isn't taken as something other than what
+// notFollowedBy was looking for.
+TEST_CASE("notFollowedBy (failed input)") {
+    BrokenStream good("ab1", 10);
+    good.get();
+    good.get();
+    parsical::notFollowedBy(good, letter);
+
+    BrokenStream bad("abcd", 0);
+    REQUIRE_THROWS_AS(parsical::notFollowedBy(bad, letter), parsical::ParseError&);
+}
+
+// Testing that label doesn't cover up bad input with what it expected.
+TEST_CASE("label (failed input)") {
+    BrokenStream bad("abcd", 0);
+    try {
+        parsical::label<char>(bad, 1, letter);
+        FAIL("label should have thrown.");
+    } catch (parsical::ParseError& e) {
+        REQUIRE(e.code() == parsical::ErrorCode::Generic);
+    }
+}
+
+////
+// grammar.hpp
+
+// Testing that Grammars behave like the functions they're built out of.
+TEST_CASE("Grammar") {
+    parsical::Grammar<std::string> ab = parsical::literal("ab");
+    parsical::Grammar<std::string> cd = parsical::literal("cd");
+    parsical::Grammar<std::vector<std::string>> pairs = parsical::manyOf(parsical::alternatives(std::vector<parsical::Grammar<std::string>> { ab, cd }));
+    parsical::Grammar<std::size_t> count = parsical::transform<std::size_t>(pairs, std::function<std::size_t(std::vector<std::string>)>([](std::vector<std::string> v) {
+        return v.size();
+    }));
+
+    parsical::StringParser p("abcdabx");
+    REQUIRE(pairs(p) == (std::vector<std::string> { "ab", "cd", "ab" }));
+    REQUIRE(p.get() == 'x');
+
+    parsical::StringParser q("cdcdab");
+    REQUIRE(count.parse(q) == 3);
+
+    parsical::StringParser r("ax");
+    REQUIRE_THROWS(ab(r));
+
+    // Unlike choice, alternatives rewinds an alternative that failed part
+    // of the way through.
+    parsical::Grammar<std::string> keyword = parsical::alternatives(std::vector<parsical::Grammar<std::string>> {
+        parsical::literal("let"),
+        parsical::literal("lex")
+    });
+    parsical::StringParser s("lex");
+    REQUIRE(keyword(s) == "lex");
+}
+
+// Testing that one Grammar can be used from many threads at once.
+TEST_CASE("Grammar (shared)") {
+    parsical::Grammar<int> number(parsical::str::parseInt);
+    parsical::Grammar<std::vector<int>> numbers = parsical::manyOf(parsical::Grammar<int>([number](parsical::ParseStream<char>& stream) -> int {
+        int n = number(stream);
+        parsical::str::consumeWhitespace(stream);
+        return n;
+    }));
+
+    std::vector<std::string> documents(200, "1 2 3 4 5 6 7 8 9 10");
+    parsical::ThreadPool pool(4);
+
+    for (parsical::BatchResult<std::vector<int>>& result: parsical::parseBatch<std::vector<int>>(documents, numbers, pool)) {
+        REQUIRE(result.ok);
+        REQUIRE(result.value.size() == 10);
+        REQUIRE(result.value.back() == 10);
+    }
+}
+
 ////
 // string.hpp
 